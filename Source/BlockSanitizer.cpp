@@ -0,0 +1,63 @@
+#include "BlockSanitizer.h"
+
+//==============================================================================
+namespace
+{
+    constexpr juce::uint32 exponentMask = 0x7f800000u;
+    constexpr juce::uint32 mantissaMask = 0x007fffffu;
+
+    juce::uint32 getBits(float value) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+}
+
+//==============================================================================
+int BlockSanitizer::scan(const float* samples, int numSamples) noexcept
+{
+    // Accumulate flags instead of branching so the loop vectorises
+    juce::uint32 anyNonFinite = 0;
+    juce::uint32 anyDenormal = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const juce::uint32 bits = getBits(samples[i]);
+        const juce::uint32 exponent = bits & exponentMask;
+
+        anyNonFinite |= static_cast<juce::uint32>(exponent == exponentMask);
+        anyDenormal |= static_cast<juce::uint32>(exponent == 0) & static_cast<juce::uint32>((bits & mantissaMask) != 0);
+    }
+
+    return (anyNonFinite != 0 ? nonFinite : clean) | (anyDenormal != 0 ? denormal : clean);
+}
+
+int BlockSanitizer::scan(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    int problems = clean;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        problems |= scan(channels[ch], numSamples);
+
+    return problems;
+}
+
+//==============================================================================
+void BlockSanitizer::repair(float* samples, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const juce::uint32 exponent = getBits(samples[i]) & exponentMask;
+
+        // Zero exponent covers denormals (and leaves +-0 unchanged)
+        if (exponent == exponentMask || exponent == 0)
+            samples[i] = 0.0f;
+    }
+}
+
+void BlockSanitizer::repair(float* const* channels, int numChannels, int numSamples) noexcept
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+        repair(channels[ch], numSamples);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Scan and repair the input too, so non-finite input never reaches the detector
+#ifndef FIDI_SANITIZE_INPUT
+ #define FIDI_SANITIZE_INPUT 1
+#endif
+
+/**
+ * Block-level signal sanitizer for FIDI Comp
+ * Replaces per-sample NaN/Inf checks with one branch-free scan per channel
+ * and block. The scan reads the float bit patterns, so the compiler can
+ * vectorise it; only a block that fails the scan pays for the repair pass.
+ * Problems are counted in lock-free counters the editor can display.
+ */
+class BlockSanitizer
+{
+public:
+    //==============================================================================
+    /** Result bits of a scan */
+    enum Problem : int
+    {
+        clean = 0,
+        nonFinite = 1 << 0,     // NaN or infinity
+        denormal = 1 << 1       // Subnormal (very slow on some CPUs)
+    };
+
+    /** Blocks with problems since the plugin was loaded (written by the audio thread) */
+    struct Counters
+    {
+        std::atomic<juce::uint32> nonFiniteInputBlocks { 0 };
+        std::atomic<juce::uint32> nonFiniteOutputBlocks { 0 };
+        std::atomic<juce::uint32> denormalOutputBlocks { 0 };
+        std::atomic<juce::uint32> detectorResets { 0 };
+    };
+
+    //==============================================================================
+    /** Scan samples for non-finite and denormal values, returns a mask of Problem bits */
+    [[nodiscard]] static int scan(const float* samples, int numSamples) noexcept;
+
+    /** Scan every channel, returns the combined mask */
+    [[nodiscard]] static int scan(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /** Replace non-finite and denormal values with zero */
+    static void repair(float* samples, int numSamples) noexcept;
+
+    static void repair(float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /** Relaxed increment for an audio-thread-only counter (no read-modify-write lock prefix) */
+    static void increment(std::atomic<juce::uint32>& counter) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+private:
+    BlockSanitizer() = delete;
+};
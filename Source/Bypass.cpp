@@ -0,0 +1,51 @@
+#include "Bypass.h"
+
+//==============================================================================
+void Bypass::prepare(double sampleRate, int numChannels, int maximumBlockSize)
+{
+    dryBuffer.setSize(juce::jmax(1, numChannels), juce::jmax(1, maximumBlockSize));
+    fadeStep = 1.0f / static_cast<float>(juce::jmax(1, juce::roundToInt(sampleRate * fadeSeconds)));
+}
+
+void Bypass::reset(bool shouldBeBypassed) noexcept
+{
+    bypassed = shouldBeBypassed;
+    dryAmount = bypassed ? 1.0f : 0.0f;
+}
+
+//==============================================================================
+void Bypass::captureDry(const juce::AudioBuffer<float>& buffer) noexcept
+{
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+
+    // Only a host exceeding the prepared block size makes this allocate
+    dryBuffer.setSize(juce::jmax(numChannels, dryBuffer.getNumChannels()),
+                      juce::jmax(numSamples, dryBuffer.getNumSamples()), false, false, true);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+}
+
+void Bypass::mixDry(juce::AudioBuffer<float>& buffer) noexcept
+{
+    const int numChannels = juce::jmin(buffer.getNumChannels(), dryBuffer.getNumChannels());
+    const int numSamples = juce::jmin(buffer.getNumSamples(), dryBuffer.getNumSamples());
+    const float step = bypassed ? fadeStep : -fadeStep;
+    float amount = dryAmount;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* dry = dryBuffer.getReadPointer(ch);
+        float* output = buffer.getWritePointer(ch);
+        amount = dryAmount;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            amount = juce::jlimit(0.0f, 1.0f, amount + step);
+            output[i] += amount * (dry[i] - output[i]);
+        }
+    }
+
+    dryAmount = amount;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Click-free bypass for FIDI Comp
+ * Crossfades between the processed signal and a copy of the input taken
+ * before processing. The crossfade runs in front of the limiter, whose
+ * lookahead delay is always in the path: both signals pass through the same
+ * delay afterwards, so the dry copy is aligned with the reported latency
+ * without a delay line of its own. Once fully bypassed the processor skips
+ * the DSP and only runs that delay.
+ */
+class Bypass
+{
+public:
+    //==============================================================================
+    static constexpr double fadeSeconds = 0.01;     // 10ms linear crossfade
+
+    Bypass() = default;
+
+    //==============================================================================
+    /** Allocate the dry copy and set the fade length (not on the audio thread) */
+    void prepare(double sampleRate, int numChannels, int maximumBlockSize);
+
+    /** Jump to a state without a crossfade */
+    void reset(bool shouldBeBypassed) noexcept;
+
+    /** Set the target state; a change starts a crossfade from wherever the current one is */
+    void setBypassed(bool shouldBeBypassed) noexcept { bypassed = shouldBeBypassed; }
+
+    [[nodiscard]] bool isBypassed() const noexcept { return bypassed; }
+
+    /** True when the output is the dry signal only (no crossfade running) */
+    [[nodiscard]] bool isFullyBypassed() const noexcept { return bypassed && dryAmount >= 1.0f; }
+
+    /** True while the output is a mix of both signals */
+    [[nodiscard]] bool isFading() const noexcept { return bypassed ? dryAmount < 1.0f : dryAmount > 0.0f; }
+
+    //==============================================================================
+    /** Copy the input before it is processed in place (only needed while fading) */
+    void captureDry(const juce::AudioBuffer<float>& buffer) noexcept;
+
+    /** Crossfade the processed block with the captured input, advancing the fade */
+    void mixDry(juce::AudioBuffer<float>& buffer) noexcept;
+
+private:
+    //==============================================================================
+    juce::AudioBuffer<float> dryBuffer;
+    bool bypassed = false;
+    float dryAmount = 0.0f;                 // 0 = processed only, 1 = dry only
+    float fadeStep = 1.0f / 480.0f;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Bypass)
+};
@@ -1,113 +1,795 @@
 #include "Compressor.h"
 
+//==============================================================================
+// Kernel table, indexed by (detector * 2 + domain) * 2 + topology
+const std::array<Compressor::Kernel, Compressor::numKernels> Compressor::kernels {
+    &Compressor::detectAndComputeGains<DetectorPolicies::Branching, DetectorPolicies::LinearDomain, DetectorPolicies::FeedForward>,
+    &Compressor::detectAndComputeGains<DetectorPolicies::Branching, DetectorPolicies::LinearDomain, DetectorPolicies::Feedback>,
+    &Compressor::detectAndComputeGains<DetectorPolicies::Branching, DetectorPolicies::LogDomain, DetectorPolicies::FeedForward>,
+    &Compressor::detectAndComputeGains<DetectorPolicies::Branching, DetectorPolicies::LogDomain, DetectorPolicies::Feedback>,
+    &Compressor::detectAndComputeGains<DetectorPolicies::Decoupled, DetectorPolicies::LinearDomain, DetectorPolicies::FeedForward>,
+    &Compressor::detectAndComputeGains<DetectorPolicies::Decoupled, DetectorPolicies::LinearDomain, DetectorPolicies::Feedback>,
+    &Compressor::detectAndComputeGains<DetectorPolicies::Decoupled, DetectorPolicies::LogDomain, DetectorPolicies::FeedForward>,
+    &Compressor::detectAndComputeGains<DetectorPolicies::Decoupled, DetectorPolicies::LogDomain, DetectorPolicies::Feedback>,
+    &Compressor::detectAndComputeGains<DetectorPolicies::SmoothPeak, DetectorPolicies::LinearDomain, DetectorPolicies::FeedForward>,
+    &Compressor::detectAndComputeGains<DetectorPolicies::SmoothPeak, DetectorPolicies::LinearDomain, DetectorPolicies::Feedback>,
+    &Compressor::detectAndComputeGains<DetectorPolicies::SmoothPeak, DetectorPolicies::LogDomain, DetectorPolicies::FeedForward>,
+    &Compressor::detectAndComputeGains<DetectorPolicies::SmoothPeak, DetectorPolicies::LogDomain, DetectorPolicies::Feedback>
+};
+
+const std::array<const char*, Compressor::numKernels> Compressor::kernelNames {
+    "Compressor::kernel branching linear feedForward",
+    "Compressor::kernel branching linear feedback",
+    "Compressor::kernel branching log feedForward",
+    "Compressor::kernel branching log feedback",
+    "Compressor::kernel decoupled linear feedForward",
+    "Compressor::kernel decoupled linear feedback",
+    "Compressor::kernel decoupled log feedForward",
+    "Compressor::kernel decoupled log feedback",
+    "Compressor::kernel smoothPeak linear feedForward",
+    "Compressor::kernel smoothPeak linear feedback",
+    "Compressor::kernel smoothPeak log feedForward",
+    "Compressor::kernel smoothPeak log feedback"
+};
+
 //==============================================================================
 Compressor::Compressor(const Parameters& params)
-    : parameters(params)
+    : parameters(params),
+      decibelTable(SharedTables::getDecibelTable())
 {
+    updateCurve();
 }
 
 //==============================================================================
 void Compressor::reset() noexcept
 {
-    envelope = 0.0;
+    const double floor = domain == DetectorDomain::log ? DetectorPolicies::LogDomain::floor
+                                                       : DetectorPolicies::LinearDomain::floor;
+    envelope[0] = floor;
+    envelope[1] = floor;
+    peakStage[0] = floor;
+    peakStage[1] = floor;
+    previousGain[0] = 1.0f;
+    previousGain[1] = 1.0f;
+    std::fill(&oversamplingHistory[0][0], &oversamplingHistory[0][0] + numLanes * 3, 0.0f);
     smoothedThreshold = parameters.threshold;
     smoothedRatio = parameters.ratio;
     smoothedKnee = parameters.knee;
     smoothedMix = parameters.mix;
     smoothedMakeup = parameters.makeupLinear;
+    smoothedLink = parameters.link;
+    smoothedExpanderThreshold = parameters.expanderThreshold;
+    smoothedExpanderRatio = parameters.expanderRatio;
+    smoothedUpwardRatio = parameters.upwardRatio;
     smoothedAttackCoeff = parameters.attackCoeff;
     smoothedReleaseCoeff = parameters.releaseCoeff;
     smoothingCounter = 0;  // Reset batch counter
+    morphSamplesRemaining = 0;
+    updateCurve();
+    bypassPeak[0] = 0.0f;
+    bypassPeak[1] = 0.0f;
+    bypassPeakSamples = 0;
+
+    // Program-dependent release state
+    releaseCoeffInUse = smoothedReleaseCoeff;
+    slowEnvelope[0] = floor;
+    slowEnvelope[1] = floor;
+    crestPeak = 0.0;
+    crestMeanSquare = 0.0;
+    crestPeakCoeff = parameters.calculateCoefficient(crestPeakReleaseMs);
+    crestMeanSquareCoeff = parameters.calculateCoefficient(crestAveragingMs);
+    lastMinGainReduction = 1.0f;
+}
+
+//==============================================================================
+bool Compressor::isPoisoned() const noexcept
+{
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        if (! std::isfinite(envelope[lane]) || ! std::isfinite(slowEnvelope[lane])
+            || ! std::isfinite(peakStage[lane]) || ! std::isfinite(previousGain[lane]))
+            return true;
+
+        for (const float sample : oversamplingHistory[lane])
+            if (! std::isfinite(sample))
+                return true;
+    }
+
+    return ! std::isfinite(crestPeak) || ! std::isfinite(crestMeanSquare);
+}
+
+//==============================================================================
+void Compressor::setTopology(Detector newDetector, DetectorDomain newDomain, Topology newTopology) noexcept
+{
+    // Carry the detector state into the new domain
+    if (newDomain != domain)
+    {
+        for (double* state : { envelope, peakStage, slowEnvelope })
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+                state[lane] = newDomain == DetectorDomain::log ? DetectorPolicies::LogDomain::fromLinear(state[lane])
+                                                               : DetectorPolicies::LogDomain::toLinear(state[lane]);
+        }
+    }
+
+    // A two-stage detector starts with its peak stage on the envelope
+    if (newDetector != detector)
+        std::copy(std::begin(envelope), std::end(envelope), std::begin(peakStage));
+
+    detector = newDetector;
+    domain = newDomain;
+    kernelIndex = (static_cast<int>(detector) * 2 + static_cast<int>(domain)) * 2 + static_cast<int>(newTopology);
+}
+
+//==============================================================================
+void Compressor::startMorph(int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    const float invLength = 1.0f / static_cast<float>(numSamples);
+
+    morphSteps.threshold = (parameters.threshold - smoothedThreshold) * invLength;
+    morphSteps.ratio = (parameters.ratio - smoothedRatio) * invLength;
+    morphSteps.knee = (parameters.knee - smoothedKnee) * invLength;
+    morphSteps.mix = (parameters.mix - smoothedMix) * invLength;
+    morphSteps.makeup = (parameters.makeupLinear - smoothedMakeup) * invLength;
+    morphSteps.link = (parameters.link - smoothedLink) * invLength;
+    morphSteps.expanderThreshold = (parameters.expanderThreshold - smoothedExpanderThreshold) * invLength;
+    morphSteps.expanderRatio = (parameters.expanderRatio - smoothedExpanderRatio) * invLength;
+    morphSteps.upwardRatio = (parameters.upwardRatio - smoothedUpwardRatio) * invLength;
+    morphSteps.attackCoeff = (parameters.attackCoeff - smoothedAttackCoeff) * invLength;
+    morphSteps.releaseCoeff = (parameters.releaseCoeff - smoothedReleaseCoeff) * invLength;
+
+    morphSamplesRemaining = numSamples;
 }
 
 //==============================================================================
-[[nodiscard]] float Compressor::computeGainReduction(float inputLevel) noexcept
+int Compressor::getNextSubBlockSize(int numSamplesRemaining) const noexcept
 {
+    const int samplesUntilSmoothing = smoothingCounter >= smoothingInterval
+                                          ? smoothingInterval
+                                          : smoothingInterval - smoothingCounter;
+
+    return std::min(numSamplesRemaining, samplesUntilSmoothing);
+}
+
+//==============================================================================
+void Compressor::advanceSmoothing(int numSamples) noexcept
+{
+    const bool smoothingDue = smoothingCounter >= smoothingInterval;
+
+    if (smoothingDue)
+        smoothingCounter = 0;
+
+    smoothingCounter += numSamples;
+
+    // Preset morph: linear ramp of per-sample steps, taken a sub-block at a time, so
+    // the curve and auto release update at the usual rate. Batched smoothing resumes afterwards.
+    if (morphSamplesRemaining > 0)
+    {
+        const int steps = std::min(numSamples, morphSamplesRemaining);
+        const auto amount = static_cast<float>(steps);
+        morphSamplesRemaining -= steps;
+
+        smoothedThreshold += morphSteps.threshold * amount;
+        smoothedRatio += morphSteps.ratio * amount;
+        smoothedKnee += morphSteps.knee * amount;
+        smoothedMix += morphSteps.mix * amount;
+        smoothedMakeup += morphSteps.makeup * amount;
+        smoothedLink += morphSteps.link * amount;
+        smoothedExpanderThreshold += morphSteps.expanderThreshold * amount;
+        smoothedExpanderRatio += morphSteps.expanderRatio * amount;
+        smoothedUpwardRatio += morphSteps.upwardRatio * amount;
+        smoothedAttackCoeff += morphSteps.attackCoeff * steps;
+        smoothedReleaseCoeff += morphSteps.releaseCoeff * steps;
+        updateCurve();
+        return;
+    }
+
     // Batch parameter smoothing: update every N samples for efficiency
     // This reduces smoothing overhead by ~7x while maintaining audio quality
-    if (++smoothingCounter >= smoothingInterval)
+    if (smoothingDue)
     {
-        smoothingCounter = 0;
-        
         // Use larger coefficient for batch update (compensate for fewer updates)
         const float batchCoeff = static_cast<float>(parameters.smoothingCoeff) * smoothingInterval;
         const float clampedCoeff = std::min(batchCoeff, 0.99f);  // Prevent overshoot
-        
+
         smoothedThreshold += clampedCoeff * (parameters.threshold - smoothedThreshold);
         smoothedRatio += clampedCoeff * (parameters.ratio - smoothedRatio);
         smoothedKnee += clampedCoeff * (parameters.knee - smoothedKnee);
         smoothedMix += clampedCoeff * (parameters.mix - smoothedMix);
         smoothedMakeup += clampedCoeff * (parameters.makeupLinear - smoothedMakeup);
+        smoothedLink += clampedCoeff * (parameters.link - smoothedLink);
+        smoothedExpanderThreshold += clampedCoeff * (parameters.expanderThreshold - smoothedExpanderThreshold);
+        smoothedExpanderRatio += clampedCoeff * (parameters.expanderRatio - smoothedExpanderRatio);
+        smoothedUpwardRatio += clampedCoeff * (parameters.upwardRatio - smoothedUpwardRatio);
         smoothedAttackCoeff += clampedCoeff * (parameters.attackCoeff - smoothedAttackCoeff);
         smoothedReleaseCoeff += clampedCoeff * (parameters.releaseCoeff - smoothedReleaseCoeff);
+        updateCurve();
+    }
+}
+
+//==============================================================================
+float Compressor::processSubBlock(const LaneBuffer& levels, LaneBuffer& gains,
+                                  int numSamples, int numActiveLanes) noexcept
+{
+    jassert(numSamples > 0 && numSamples <= maxSubBlockSize);
+
+    advanceSmoothing(numSamples);
+    updateAutoRelease(levels, numSamples, numActiveLanes);
+
+    lastMinGainReduction = (this->*kernels[static_cast<size_t>(kernelIndex)])(levels, gains, numSamples, numActiveLanes);
+    return lastMinGainReduction;
+}
+
+float Compressor::analyseSubBlock(const LaneBuffer& levels, int numSamples, int numActiveLanes) noexcept
+{
+    // The kernels still need somewhere to keep the envelopes
+    LaneBuffer envelopes;
+
+    gainsWanted = false;
+    const float minGainReduction = processSubBlock(levels, envelopes, numSamples, numActiveLanes);
+    gainsWanted = true;
+    return minGainReduction;
+}
+
+void Compressor::updateWhileBypassed(const float* const* channels, int numSamples,
+                                     int numActiveLanes) noexcept
+{
+    // Peaks gather over a whole sub-block, across host calls too, so tiny
+    // host blocks cost one envelope step per sub-block like large ones. Steps
+    // fall on the sub-block boundaries of the active path.
+    for (int start = 0; start < numSamples;)
+    {
+        const int count = getNextSubBlockSize(numSamples - start);
+        advanceSmoothing(count);
+
+        for (int lane = 0; lane < numActiveLanes; ++lane)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(channels[lane] + start, count);
+            bypassPeak[lane] = std::max({ bypassPeak[lane], -range.getStart(), range.getEnd() });
+        }
+
+        start += count;
+        bypassPeakSamples += count;
+
+        if (smoothingCounter < smoothingInterval)
+            continue;
+
+        if (numActiveLanes == 1)
+            bypassPeak[1] = bypassPeak[0];
+
+        // Decimated coefficients for a full sub-block, recomputed only when the smoothed ones moved
+        if (smoothedAttackCoeff != bypassAttackCoeff || releaseCoeffInUse != bypassReleaseCoeff)
+        {
+            bypassAttackCoeff = smoothedAttackCoeff;
+            bypassReleaseCoeff = releaseCoeffInUse;
+            bypassAttackFull = std::pow(bypassAttackCoeff, static_cast<double>(maxSubBlockSize));
+            bypassReleaseFull = std::pow(bypassReleaseCoeff, static_cast<double>(maxSubBlockSize));
+        }
+
+        // Shorter only for the partial sub-block bypass started in
+        const bool fullSubBlock = bypassPeakSamples == maxSubBlockSize;
+        const double attack = fullSubBlock ? bypassAttackFull : std::pow(smoothedAttackCoeff, static_cast<double>(bypassPeakSamples));
+        const double release = fullSubBlock ? bypassReleaseFull : std::pow(releaseCoeffInUse, static_cast<double>(bypassPeakSamples));
+
+        // Same blend towards the louder lane as the linked detector path
+        const float loudest = std::max(bypassPeak[0], bypassPeak[1]);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const double linearLevel = bypassPeak[lane] + smoothedLink * (loudest - bypassPeak[lane]);
+            const double level = domain == DetectorDomain::log ? DetectorPolicies::LogDomain::fromLinear(linearLevel)
+                                                               : linearLevel;
+            const double coeff = level > envelope[lane] ? attack : release;
+            envelope[lane] = coeff * (envelope[lane] - level) + level;
+            slowEnvelope[lane] = envelope[lane];
+            peakStage[lane] = envelope[lane];
+            bypassPeak[lane] = 0.0f;
+        }
+
+        bypassPeakSamples = 0;
+    }
+}
+
+template <typename DetectorPolicy, typename DomainPolicy, typename TopologyPolicy>
+float Compressor::detectAndComputeGains(const LaneBuffer& levels, LaneBuffer& gains,
+                                        int numSamples, int numActiveLanes) noexcept
+{
+    if constexpr (TopologyPolicy::isFeedback)
+        return detectFeedback<DetectorPolicy, DomainPolicy>(levels, gains, numSamples, numActiveLanes);
+    else
+        return detectFeedForward<DetectorPolicy, DomainPolicy>(levels, gains, numSamples, numActiveLanes);
+}
+
+template <typename DetectorPolicy, typename DomainPolicy>
+float Compressor::detectFeedForward(const LaneBuffer& levels, LaneBuffer& gains,
+                                    int numSamples, int numActiveLanes) noexcept
+{
+    // Mono: a single detector on lane 0
+    if (numActiveLanes == 1)
+    {
+        const float* detectorInput = levels.samples[0];
+
+        if constexpr (DomainPolicy::isLog)
+        {
+            toDetectorDomain(levels.samples[0], gains.samples[1], numSamples);  // Lane 1 output is free in mono
+            detectorInput = gains.samples[1];
+        }
+
+        followEnvelope<DetectorPolicy, DomainPolicy>(detectorInput, gains.samples[0], 0, numSamples);
+        envelope[1] = envelope[0];
+        peakStage[1] = peakStage[0];
+
+        if (autoReleaseActive)
+        {
+            applySlowRelease<DomainPolicy>(detectorInput, gains.samples[0], slowEnvelope[0], numSamples);
+            slowEnvelope[1] = slowEnvelope[0];
+        }
+
+        const float minGainReduction = computeGains<DomainPolicy>(gains, numSamples, 1);
+        previousGain[1] = previousGain[0];
+        return minGainReduction;
     }
 
-    // Envelope follower operates in LINEAR domain (not dB!)
-    // This matches the skill reference pattern
-    double coeff = (inputLevel > envelope) ? smoothedAttackCoeff : smoothedReleaseCoeff;
-    envelope = coeff * (envelope - inputLevel) + inputLevel;
-    
-    // Ensure envelope doesn't go negative
-    if (envelope < 0.0)
-        envelope = 0.0;
+    // Fully linked L/R: one detector on max of both lanes (the classic stereo-linked path)
+    if (smoothedLink >= fullyLinkedThreshold && ! midSide)
+    {
+        float* linkedLevel = gains.samples[1];  // Lane 1 output doubles as scratch
+
+        for (int i = 0; i < numSamples; ++i)
+            linkedLevel[i] = std::max(levels.samples[0][i], levels.samples[1][i]);
 
-    // AFTER smoothing: convert envelope to dB for gain computation
-    constexpr float minLevel = 1e-10f;
-    float envelopeDb = juce::Decibels::gainToDecibels(
-        static_cast<float>(std::max(envelope, static_cast<double>(minLevel))));
+        if constexpr (DomainPolicy::isLog)
+            toDetectorDomain(linkedLevel, linkedLevel, numSamples);
 
-    // Compute gain reduction based on envelope (in dB domain)
-    float gainReductionDb = computeGainReductionDb(envelopeDb);
+        followEnvelope<DetectorPolicy, DomainPolicy>(linkedLevel, gains.samples[0], 0, numSamples);
+        envelope[1] = envelope[0];
+        peakStage[1] = peakStage[0];
 
-    // Convert dB reduction to linear gain
-    // gainReductionDb is positive (e.g., 6dB of reduction)
-    // We need to return a multiplier < 1.0
-    float gainReduction = juce::Decibels::decibelsToGain(-gainReductionDb);
+        if (autoReleaseActive)
+        {
+            applySlowRelease<DomainPolicy>(linkedLevel, gains.samples[0], slowEnvelope[0], numSamples);
+            slowEnvelope[1] = slowEnvelope[0];
+        }
+
+        const float minGainReduction = computeGains<DomainPolicy>(gains, numSamples, 1);
+        previousGain[1] = previousGain[0];
+        std::copy(gains.samples[0], gains.samples[0] + numSamples, gains.samples[1]);
+        return minGainReduction;
+    }
 
-    // Safety check: prevent NaN/Inf (can occur with extreme parameter values)
-    if (std::isnan(gainReduction) || std::isinf(gainReduction))
-        gainReduction = 1.0f;
-    
-    // Clamp to valid range [0.0, 1.0] for safety
-    gainReduction = std::clamp(gainReduction, 0.0f, 1.0f);
+    // Partially linked, or M/S: each lane detects its own level pulled towards the linked level
+    LaneBuffer detectorInput;
+    float laneLink[numLanes];
+    getLaneLinks(laneLink);
 
-    return gainReduction;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float linkedLevel = std::max(levels.samples[0][i], levels.samples[1][i]);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const float ownLevel = levels.samples[lane][i];
+            detectorInput.samples[lane][i] = ownLevel + laneLink[lane] * (linkedLevel - ownLevel);
+        }
+    }
+
+    if constexpr (DomainPolicy::isLog)
+        for (int lane = 0; lane < numLanes; ++lane)
+            toDetectorDomain(detectorInput.samples[lane], detectorInput.samples[lane], numSamples);
+
+    followEnvelopes<DetectorPolicy, DomainPolicy>(detectorInput, gains, numSamples);
+
+    if (autoReleaseActive)
+        for (int lane = 0; lane < numLanes; ++lane)
+            applySlowRelease<DomainPolicy>(detectorInput.samples[lane], gains.samples[lane], slowEnvelope[lane], numSamples);
+
+    return computeGains<DomainPolicy>(gains, numSamples, numLanes);
+}
+
+template <typename DetectorPolicy, typename DomainPolicy>
+float Compressor::detectFeedback(const LaneBuffer& levels, LaneBuffer& gains,
+                                 int numSamples, int numActiveLanes) noexcept
+{
+    using DetectorPolicies::Lanes;
+
+    const StaticCurve curve = smoothedCurve;
+    const float mixAmount = smoothedMix;
+    const float dryAmount = 1.0f - mixAmount;
+    const float makeupGain = smoothedMakeup;
+    const double attackCoeff = smoothedAttackCoeff;
+    const double releaseCoeff = releaseCoeffInUse;
+
+    auto toGain = [&](double envelopeValue)
+    {
+        return decibelTable->decibelsToGain(curve.getGainDb(envelopeToDecibels<DomainPolicy>(static_cast<float>(envelopeValue))));
+    };
+
+    float minGainReduction = 1.0f;
+
+    // Mono: one detector on lane 0, fed back its own gain reduction
+    if (numActiveLanes == 1)
+    {
+        double state = envelope[0];
+        double peak = peakStage[0];
+        double slowState = slowEnvelope[0];
+        float gain = previousGain[0];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double input = DomainPolicy::fromLinear(static_cast<double>(levels.samples[0][i] * gain));
+            double envelopeValue = DetectorPolicy::step(input, state, peak, attackCoeff, releaseCoeff, DomainPolicy::floor);
+
+            if (autoReleaseActive)
+            {
+                const double coeff = (input > slowState) ? slowAttackCoeff : slowReleaseCoeff;
+                slowState = std::max(coeff * (slowState - input) + input, DomainPolicy::floor);
+                envelopeValue = std::max(envelopeValue, slowState);
+            }
+
+            gain = toGain(envelopeValue);
+            minGainReduction = std::min(minGainReduction, gain);
+            gains.samples[0][i] = makeupGain * (dryAmount + mixAmount * gain);
+        }
+
+        envelope[0] = envelope[1] = state;
+        peakStage[0] = peakStage[1] = peak;
+        slowEnvelope[0] = slowEnvelope[1] = slowState;
+        previousGain[0] = previousGain[1] = gain;
+        return minGainReduction;
+    }
+
+    // Stereo: the link blends the input levels, both lanes' detectors step together
+    // in one register, and each lane feeds back its own gain reduction
+    float laneLink[numLanes];
+    getLaneLinks(laneLink);
+
+    const Lanes attack = Lanes::expand(attackCoeff);
+    const Lanes release = Lanes::expand(releaseCoeff);
+    const Lanes slowAttack = Lanes::expand(slowAttackCoeff);
+    const Lanes slowRelease = Lanes::expand(slowReleaseCoeff);
+    const Lanes floor = Lanes::expand(DomainPolicy::floor);
+
+    Lanes state = DetectorPolicies::loadLanes(envelope[0], envelope[1]);
+    Lanes peak = DetectorPolicies::loadLanes(peakStage[0], peakStage[1]);
+    Lanes slowState = DetectorPolicies::loadLanes(slowEnvelope[0], slowEnvelope[1]);
+    float gain[numLanes] = { previousGain[0], previousGain[1] };
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float linkedLevel = std::max(levels.samples[0][i], levels.samples[1][i]);
+        double laneInput[numLanes];
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const float ownLevel = levels.samples[lane][i];
+            const float level = ownLevel + laneLink[lane] * (linkedLevel - ownLevel);
+            laneInput[lane] = DomainPolicy::fromLinear(static_cast<double>(level * gain[lane]));
+        }
+
+        const Lanes input = DetectorPolicies::loadLanes(laneInput[0], laneInput[1]);
+        Lanes envelopeValue = DetectorPolicy::stepLanes(input, state, peak, attack, release, floor);
+
+        if (autoReleaseActive)
+        {
+            const auto attacking = Lanes::greaterThan(input, slowState);
+            const Lanes coeff = (slowAttack & attacking) + (slowRelease & ~attacking);
+            slowState = Lanes::max(coeff * (slowState - input) + input, floor);
+            envelopeValue = Lanes::max(envelopeValue, slowState);
+        }
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            gain[lane] = toGain(envelopeValue.get(static_cast<size_t>(lane)));
+            minGainReduction = std::min(minGainReduction, gain[lane]);
+            gains.samples[lane][i] = makeupGain * (dryAmount + mixAmount * gain[lane]);
+        }
+    }
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        envelope[lane] = state.get(static_cast<size_t>(lane));
+        peakStage[lane] = peak.get(static_cast<size_t>(lane));
+        slowEnvelope[lane] = slowState.get(static_cast<size_t>(lane));
+        previousGain[lane] = gain[lane];
+    }
+
+    return minGainReduction;
+}
+
+void Compressor::getLaneLinks(float* laneLink) const noexcept
+{
+    // In M/S the mid detector stays on its own level and only the side follows
+    // the louder lane, so side never gets less gain reduction than mid and full
+    // link keeps the image from widening instead of collapsing to one gain
+    const float link = std::clamp(smoothedLink, 0.0f, 1.0f);
+    laneLink[0] = midSide ? 0.0f : link;
+    laneLink[1] = link;
+}
+
+void Compressor::toDetectorDomain(const float* input, float* output, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+        output[i] = static_cast<float>(DetectorPolicies::LogDomain::fromLinear(input[i]));
+}
+
+//==============================================================================
+void Compressor::updateAutoRelease(const LaneBuffer& levels, int numSamples, int numActiveLanes) noexcept
+{
+    autoReleaseActive = parameters.autoRelease;
+
+    if (! autoReleaseActive)
+    {
+        releaseCoeffInUse = smoothedReleaseCoeff;
+        return;
+    }
+
+    // Running statistics of the loudest lane: one max and one multiply-add each per sample
+    const float* otherLane = numActiveLanes > 1 ? levels.samples[1] : levels.samples[0];
+    double peak = crestPeak;
+    double meanSquare = crestMeanSquare;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double level = std::max(levels.samples[0][i], otherLane[i]);
+        peak = std::max(level, crestPeakCoeff * peak);
+        meanSquare = crestMeanSquareCoeff * (meanSquare - level * level) + level * level;
+    }
+
+    crestPeak = peak;
+    crestMeanSquare = meanSquare;
+
+    // Crest factor: ~3 dB for sustained tones, 15-20 dB for drums (silence counts as transient)
+    constexpr double minCrestDb = 3.0;
+    constexpr double maxCrestDb = 20.0;
+    const double crestDb = meanSquare > 1.0e-12
+                               ? 10.0 * std::log10(std::max(peak * peak / meanSquare, 1.0))
+                               : maxCrestDb;
+
+    // Transient material releases faster; dense material slower to avoid distortion
+    const double crestScale = juce::jmap(juce::jlimit(minCrestDb, maxCrestDb, crestDb),
+                                         minCrestDb, maxCrestDb, 2.0, 0.5);
+
+    // Deep gain reduction releases slower so the recovery is not heard as pumping
+    constexpr double maxDepthDb = 24.0;
+    const double depthDb = -20.0 * std::log10(std::max(static_cast<double>(lastMinGainReduction), 1.0e-5));
+    const double depthScale = 1.0 + juce::jlimit(0.0, maxDepthDb, depthDb) / maxDepthDb;
+
+    // Per sub-block coefficients from the shared table, no std::exp
+    const double releaseMs = parameters.releaseMs * crestScale * depthScale;
+    releaseCoeffInUse = parameters.calculateCoefficient(releaseMs);
+    slowAttackCoeff = parameters.calculateCoefficient(releaseMs * slowAttackScale);
+    slowReleaseCoeff = parameters.calculateCoefficient(releaseMs * slowReleaseScale);
+}
+
+template <typename DomainPolicy>
+void Compressor::applySlowRelease(const float* input, float* envelopeOutput, double& laneSlowEnvelope,
+                                  int numSamples) const noexcept
+{
+    // The slow stage only charges up under sustained level, so short peaks recover
+    // on the fast release while long passages hold and then let go gradually
+    double state = laneSlowEnvelope;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double inputLevel = input[i];
+        const double coeff = (inputLevel > state) ? slowAttackCoeff : slowReleaseCoeff;
+        state = std::max(coeff * (state - inputLevel) + inputLevel, DomainPolicy::floor);
+        envelopeOutput[i] = std::max(envelopeOutput[i], static_cast<float>(state));
+    }
+
+    laneSlowEnvelope = state;
 }
 
 //==============================================================================
-[[nodiscard]] float Compressor::computeGainReductionDb(float inputDb) const noexcept
+template <typename DetectorPolicy, typename DomainPolicy>
+void Compressor::followEnvelope(const float* input, float* output, int lane, int numSamples) noexcept
 {
-    const float threshold = smoothedThreshold;
-    const float ratio = smoothedRatio;
-    const float kneeWidth = smoothedKnee;
-    const float halfKnee = kneeWidth * 0.5f;
+    const double attackCoeff = smoothedAttackCoeff;
+    const double releaseCoeff = releaseCoeffInUse;
+    double state = envelope[lane];
+    double peak = peakStage[lane];
+
+    for (int i = 0; i < numSamples; ++i)
+        output[i] = static_cast<float>(DetectorPolicy::step(input[i], state, peak, attackCoeff, releaseCoeff,
+                                                            DomainPolicy::floor));
 
-    // Below knee region: no compression
-    if (inputDb <= threshold - halfKnee)
+    envelope[lane] = state;
+    peakStage[lane] = peak;
+}
+
+template <typename DetectorPolicy, typename DomainPolicy>
+void Compressor::followEnvelopes(const LaneBuffer& input, LaneBuffer& output, int numSamples) noexcept
+{
+    using DetectorPolicies::Lanes;
+
+    // Both lanes live in one register and step together; the attack/release
+    // choice is a per-lane mask, so the loop has no branches
+    const Lanes attack = Lanes::expand(smoothedAttackCoeff);
+    const Lanes release = Lanes::expand(releaseCoeffInUse);
+    const Lanes floor = Lanes::expand(DomainPolicy::floor);
+    Lanes state = DetectorPolicies::loadLanes(envelope[0], envelope[1]);
+    Lanes peak = DetectorPolicies::loadLanes(peakStage[0], peakStage[1]);
+
+    for (int i = 0; i < numSamples; ++i)
     {
-        return 0.0f;
+        const Lanes laneInput = DetectorPolicies::loadLanes(input.samples[0][i], input.samples[1][i]);
+        const Lanes envelopeValue = DetectorPolicy::stepLanes(laneInput, state, peak, attack, release, floor);
+        output.samples[0][i] = static_cast<float>(envelopeValue.get(0));
+        output.samples[1][i] = static_cast<float>(envelopeValue.get(1));
     }
 
-    // Above knee region: full compression
-    if (inputDb >= threshold + halfKnee)
+    for (int lane = 0; lane < numLanes; ++lane)
     {
-        float overDb = inputDb - threshold;
-        float gainReductionDb = overDb - (overDb / ratio);
-        return gainReductionDb;
+        envelope[lane] = state.get(static_cast<size_t>(lane));
+        peakStage[lane] = peak.get(static_cast<size_t>(lane));
     }
+}
 
-    // Inside knee region: smooth quadratic transition for professional sound
-    // Using squared ratio gives C1 continuity (no slope discontinuity at knee edges)
-    float kneePosition = inputDb - (threshold - halfKnee);
-    float kneeRatio = kneePosition / kneeWidth;  // 0 to 1 within knee
-    
-    // Quadratic interpolation: smoother than linear, matches pro compressors
-    float kneeRatioSquared = kneeRatio * kneeRatio;
-    float effectiveRatio = 1.0f + (ratio - 1.0f) * kneeRatioSquared;
-    
-    // Calculate gain reduction using interpolated ratio
-    float overDb = kneePosition;  // Distance into knee region
-    float gainReductionDb = overDb - (overDb / effectiveRatio);
-    
-    return gainReductionDb;
+//==============================================================================
+void Compressor::updateCurve() noexcept
+{
+    smoothedCurve = StaticCurve::create(smoothedThreshold, smoothedRatio, smoothedKnee,
+                               smoothedExpanderThreshold, smoothedExpanderRatio, smoothedUpwardRatio);
+}
+
+//==============================================================================
+template <typename DomainPolicy>
+float Compressor::computeGains(LaneBuffer& envelopeToGain, int numSamples, int numGainLanes) noexcept
+{
+    // Reference builds render every tier with the exact per-sample kernel
+    if (quality == Quality::eco && ! FIDI_REFERENCE_KERNELS)
+        return computeGainsControlRate<DomainPolicy>(envelopeToGain, numSamples, numGainLanes);
+
+    return computeGainsPerSample<DomainPolicy>(envelopeToGain, numSamples, numGainLanes);
+}
+
+template <typename DomainPolicy>
+float Compressor::envelopeToDecibels(float envelopeValue) noexcept
+{
+    if constexpr (DomainPolicy::isLog)
+    {
+        return envelopeValue;
+    }
+    else
+    {
+        constexpr float minLevel = 1e-10f;
+        constexpr float minDb = -100.0f;
+        return std::max(20.0f * std::log10(std::max(envelopeValue, minLevel)), minDb);
+    }
+}
+
+template <typename DomainPolicy>
+float Compressor::computeGainsPerSample(LaneBuffer& envelopeToGain, int numSamples, int numGainLanes) noexcept
+{
+    const StaticCurve curve = smoothedCurve;
+    const float mixAmount = smoothedMix;
+    const float dryAmount = 1.0f - mixAmount;
+    const float makeupGain = smoothedMakeup;
+
+    float minGainReduction = 1.0f;
+    float gain[numLanes] = { previousGain[0], previousGain[1] };
+
+    // One pass for the lane pair. No branches in this loop: the curve segments
+    // combine with min/max/select
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int lane = 0; lane < numGainLanes; ++lane)
+        {
+            float& value = envelopeToGain.samples[lane][i];
+
+            // AFTER smoothing: convert envelope to dB for gain computation
+            const float envelopeDb = envelopeToDecibels<DomainPolicy>(value);
+
+            // Gain from the static curve (negative = reduction, positive = upward boost).
+            // The table clamps NaN, and the processor's block scan catches anything else.
+            const float gainDb = curve.getGainDb(envelopeDb);
+            gain[lane] = decibelTable->decibelsToGain(gainDb);
+            minGainReduction = std::min(minGainReduction, gain[lane]);
+
+            // Parallel mix and makeup folded into one gain: makeup * (dry + wet * gain)
+            value = makeupGain * (dryAmount + mixAmount * gain[lane]);
+        }
+    }
+
+    std::copy(gain, gain + numGainLanes, previousGain);
+    return minGainReduction;
+}
+
+template <typename DomainPolicy>
+float Compressor::computeGainsControlRate(LaneBuffer& envelopeToGain, int numSamples, int numGainLanes) noexcept
+{
+    const StaticCurve curve = smoothedCurve;
+    const float mixAmount = smoothedMix;
+    const float dryAmount = 1.0f - mixAmount;
+    const float makeupGain = smoothedMakeup;
+
+    float minGainReduction = 1.0f;
+
+    for (int start = 0; start < numSamples; start += controlInterval)
+    {
+        const int count = std::min(controlInterval, numSamples - start);
+
+        for (int lane = 0; lane < numGainLanes; ++lane)
+        {
+            float* laneGains = envelopeToGain.samples[lane];
+            float gain = previousGain[lane];
+
+            // Curve evaluated once per control period, at its last sample
+            float envelopeDb = laneGains[start + count - 1];
+
+            if constexpr (! DomainPolicy::isLog)
+            {
+                constexpr float minLevel = 1e-10f;
+                constexpr float minDb = -100.0f;
+                envelopeDb = std::max(fastGainToDecibels(std::max(envelopeDb, minLevel)), minDb);
+            }
+            const float gainDb = curve.getGainDb(envelopeDb);
+            const float targetGain = decibelTable->decibelsToGain(gainDb);
+            const float step = (targetGain - gain) / static_cast<float>(count);
+            minGainReduction = std::min(minGainReduction, targetGain);
+
+            if (gainsWanted)
+            {
+                for (int i = start; i < start + count; ++i)
+                {
+                    gain += step;
+                    laneGains[i] = makeupGain * (dryAmount + mixAmount * gain);
+                }
+            }
+
+            previousGain[lane] = targetGain;  // No accumulated rounding drift
+        }
+    }
+
+    return minGainReduction;
+}
+
+float Compressor::fastGainToDecibels(float gain) noexcept
+{
+    // log2 from the float exponent plus a cubic least-squares fit of the mantissa in [1, 2)
+    juce::uint32 bits;
+    std::memcpy(&bits, &gain, sizeof(bits));
+
+    const auto exponent = static_cast<float>(static_cast<int>((bits >> 23) & 0xff) - 127);
+    bits = (bits & 0x007fffffu) | 0x3f800000u;
+
+    float mantissa;
+    std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    const float log2 = exponent - 2.13384771f
+                     + mantissa * (3.01078397f + mantissa * (-1.02952195f + mantissa * 0.15391848f));
+    return 6.0205999f * log2;   // 20 * log10(2)
+}
+
+//==============================================================================
+void Compressor::fillOversampledLevels(const float* const* lanes, LaneBuffer& levels,
+                                       int numSamples, int numActiveLanes) noexcept
+{
+    for (int lane = 0; lane < numActiveLanes; ++lane)
+    {
+        const float* input = lanes[lane];
+        float* output = levels.samples[lane];
+        float* history = oversamplingHistory[lane];
+        float x3 = history[0], x2 = history[1], x1 = history[2];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x0 = input[i];
+
+            // Cubic (4-point Lagrange) value halfway between x[n-2] and x[n-1]
+            const float midpoint = (9.0f * (x2 + x1) - (x3 + x0)) * 0.0625f;
+            output[i] = std::max(std::abs(x0), std::abs(midpoint));
+
+            x3 = x2;
+            x2 = x1;
+            x1 = x0;
+        }
+
+        history[0] = x3;
+        history[1] = x2;
+        history[2] = x1;
+    }
 }
@@ -1,15 +1,75 @@
 #pragma once
 
+#include "DetectorPolicies.h"
 #include "Parameters.h"
+#include "StaticCurve.h"
 
 /**
  * Compressor DSP class for FIDI Comp
- * Implements envelope following and gain computation with soft knee.
+ * Implements envelope following and a multi-segment static curve
+ * (expander/gate, upward compression, soft-knee compression).
+ * Processes two detector lanes (L/R or M/S) side by side in short sub-blocks,
+ * with a variable stereo link between them (in M/S only the side lane follows
+ * the link; mid always detects its own level). An optional program-dependent
+ * release adapts to crest factor and gain reduction depth. Three quality
+ * tiers select the gain computer and detector kernels.
+ *
+ * The detector topology (detector, domain, feed-forward or feedback) is a set
+ * of compile-time policies from DetectorPolicies.h. Every combination is its
+ * own kernel instantiation, and setTopology() picks one per block.
  * This class is designed to be lightweight and efficient for real-time processing.
  */
 class Compressor
 {
 public:
+    //==============================================================================
+    static constexpr int numLanes = 2;
+    static constexpr int maxSubBlockSize = 32;   // One sub-block per batched smoothing step
+
+    /**
+     * Kernel variants:
+     *  - eco: static curve once per controlInterval samples with a fast log
+     *    approximation, gain interpolated linearly in between
+     *  - standard: exact static curve for every sample
+     *  - high: standard plus 2x oversampled (inter-sample) peak detection
+     */
+    enum class Quality
+    {
+        eco,
+        standard,
+        high
+    };
+
+    static constexpr int controlInterval = 8;   // Eco gain computer period
+
+    /** Detector policies, in the order of the "detector" choice */
+    enum class Detector
+    {
+        branching,
+        decoupled,
+        smoothPeak
+    };
+
+    /** Domain policies, in the order of the "detectorDomain" choice */
+    enum class DetectorDomain
+    {
+        linear,
+        log
+    };
+
+    /** Topology policies, in the order of the "topology" choice */
+    enum class Topology
+    {
+        feedForward,
+        feedback
+    };
+
+    /** Per-lane sample storage for one sub-block */
+    struct alignas(16) LaneBuffer
+    {
+        float samples[numLanes][maxSubBlockSize];
+    };
+
     //==============================================================================
     explicit Compressor(const Parameters& params);
 
@@ -18,26 +78,179 @@ public:
     void reset() noexcept;
 
     /**
-     * Compute gain reduction for a given input level.
-     * @param inputLevel Absolute value of input sample (or linked level for stereo)
-     * @return Gain multiplier to apply (1.0 = no reduction, 0.5 = -6dB reduction)
+     * Morph all smoothed values linearly to the current parameter targets.
+     * Used for preset changes: replaces the batched smoothing with a linear
+     * ramp over the given number of samples, advanced once per sub-block.
+     */
+    void startMorph(int numSamples) noexcept;
+
+    /**
+     * Length of the next sub-block to pass to processSubBlock.
+     * Sub-blocks end where the batched smoothing updates, so parameters are
+     * constant inside one (a preset morph too).
+     */
+    [[nodiscard]] int getNextSubBlockSize(int numSamplesRemaining) const noexcept;
+
+    /** True if non-finite values got into the detector state (call reset() to recover) */
+    [[nodiscard]] bool isPoisoned() const noexcept;
+
+    /** Select the kernels for the following sub-blocks (switching is click-free) */
+    void setQuality(Quality newQuality) noexcept { quality = newQuality; }
+
+    [[nodiscard]] Quality getQuality() const noexcept { return quality; }
+
+    /** True when the lanes carry mid and side: the link then pulls only the side lane */
+    void setMidSide(bool shouldUseMidSide) noexcept { midSide = shouldUseMidSide; }
+
+    /**
+     * Select the detector kernel for the following sub-blocks. A domain change
+     * converts the detector state, so switching does not click.
+     */
+    void setTopology(Detector newDetector, DetectorDomain newDomain, Topology newTopology) noexcept;
+
+    /** Trace zone name of the selected kernel, for per-topology timing */
+    [[nodiscard]] const char* getKernelName() const noexcept { return kernelNames[static_cast<size_t>(kernelIndex)]; }
+
+    /**
+     * High quality detector input: per lane the larger of |x| and the peak
+     * between the two previous samples, interpolated with a 4-point cubic
+     * (adds one sample of detector delay for the inter-sample part).
+     * @param lanes Signed lane samples (lane 1 is ignored for mono)
+     */
+    void fillOversampledLevels(const float* const* lanes, LaneBuffer& levels,
+                               int numSamples, int numActiveLanes) noexcept;
+
+    /**
+     * Run detection and gain computation for one sub-block.
+     * @param levels Absolute detector input per lane
+     * @param gains Receives the gain to apply per lane, including mix and makeup
+     * @param numSamples Sub-block length from getNextSubBlockSize()
+     * @param numActiveLanes 1 for mono (only lane 0 is read and written), 2 for stereo
+     * @return Minimum gain reduction in the sub-block (1.0 = no reduction) for metering
+     */
+    float processSubBlock(const LaneBuffer& levels, LaneBuffer& gains,
+                          int numSamples, int numActiveLanes) noexcept;
+
+    /**
+     * processSubBlock for statistics only: same detectors and state, but the Eco
+     * gain computer only evaluates the curve once per control period and writes
+     * no per-sample gains.
+     * @return Minimum gain reduction in the sub-block (1.0 = no reduction)
+     */
+    float analyseSubBlock(const LaneBuffer& levels, int numSamples, int numActiveLanes) noexcept;
+
+    /**
+     * Keep the detectors warm while bypassed: one envelope step per sub-block
+     * (sub-blocks continue across host calls) on its peak, with the
+     * coefficients raised to the sub-block length, so the gain is close to
+     * right again when the bypass is released. Lanes are the input channels
+     * (no M/S encode) and auto release holds its last choice.
+     * @param channels Input channels (lane 1 is ignored for mono)
      */
-    [[nodiscard]] float computeGainReduction(float inputLevel) noexcept;
+    void updateWhileBypassed(const float* const* channels, int numSamples, int numActiveLanes) noexcept;
 
 private:
     //==============================================================================
+    /** Batched smoothing step or one preset morph step, at the start of a sub-block */
+    void advanceSmoothing(int numSamples) noexcept;
+
+    /** Run the detectors and gain computer for the active lanes, returns the minimum gain reduction */
+    template <typename DetectorPolicy, typename DomainPolicy, typename TopologyPolicy>
+    float detectAndComputeGains(const LaneBuffer& levels, LaneBuffer& gains,
+                                int numSamples, int numActiveLanes) noexcept;
+
+    /** Feed-forward kernel: detector over the sub-block, then the gain computer of the quality tier */
+    template <typename DetectorPolicy, typename DomainPolicy>
+    float detectFeedForward(const LaneBuffer& levels, LaneBuffer& gains,
+                            int numSamples, int numActiveLanes) noexcept;
+
+    /**
+     * Feedback kernel: each lane detects its level after the previous sample's
+     * gain reduction, so detector and gain computer run in one fused per-sample
+     * loop (always the exact curve).
+     */
+    template <typename DetectorPolicy, typename DomainPolicy>
+    float detectFeedback(const LaneBuffer& levels, LaneBuffer& gains,
+                         int numSamples, int numActiveLanes) noexcept;
+
+    /** Link amount per lane for the partially linked paths (clamped, mid unlinked in M/S) */
+    void getLaneLinks(float* laneLink) const noexcept;
+
+    /** Convert linear levels into the detector domain (log domain only) */
+    static void toDetectorDomain(const float* input, float* output, int numSamples) noexcept;
+
+    using Kernel = float (Compressor::*)(const LaneBuffer&, LaneBuffer&, int, int) noexcept;
+
+    static constexpr int numKernels = 12;       // 3 detectors x 2 domains x 2 topologies
+    static const std::array<Kernel, numKernels> kernels;
+    static const std::array<const char*, numKernels> kernelNames;
+
+    /**
+     * Program-dependent release: update the running peak/RMS statistics and
+     * pick the release for this sub-block (coefficients come from the table).
+     */
+    void updateAutoRelease(const LaneBuffer& levels, int numSamples, int numActiveLanes) noexcept;
+
+    /** Opto-style second release stage: raise the envelope to a slow follower of the same input */
+    template <typename DomainPolicy>
+    void applySlowRelease(const float* input, float* envelopeOutput, double& laneSlowEnvelope,
+                          int numSamples) const noexcept;
+
+    /** Envelope follower for one lane (input in the detector domain), writes the envelope into output */
+    template <typename DetectorPolicy, typename DomainPolicy>
+    void followEnvelope(const float* input, float* output, int lane, int numSamples) noexcept;
+
+    /** Envelope followers for both lanes, stepped together in one SIMD register */
+    template <typename DetectorPolicy, typename DomainPolicy>
+    void followEnvelopes(const LaneBuffer& input, LaneBuffer& output, int numSamples) noexcept;
+
     /**
-     * Compute gain reduction in dB using soft knee algorithm.
-     * @param inputDb Input level in dB
-     * @return Gain reduction in dB (positive value)
+     * Turn envelope values into gains to apply (in place) with the kernel of the current tier.
+     * @param numGainLanes 1 when lane 0 carries the only envelope, 2 to do the lane pair in one pass
+     * @return Minimum gain reduction of the processed samples
      */
-    [[nodiscard]] float computeGainReductionDb(float inputDb) const noexcept;
+    template <typename DomainPolicy>
+    float computeGains(LaneBuffer& envelopeToGain, int numSamples, int numGainLanes) noexcept;
+
+    /** Standard/high kernel: exact curve for every sample, one branchless pass */
+    template <typename DomainPolicy>
+    float computeGainsPerSample(LaneBuffer& envelopeToGain, int numSamples, int numGainLanes) noexcept;
+
+    /** Eco kernel: curve at control rate, linear gain interpolation in between */
+    template <typename DomainPolicy>
+    float computeGainsControlRate(LaneBuffer& envelopeToGain, int numSamples, int numGainLanes) noexcept;
+
+    /** Envelope value in dB (the log domain already is) */
+    template <typename DomainPolicy>
+    [[nodiscard]] static float envelopeToDecibels(float envelopeValue) noexcept;
+
+    /** Approximate 20 * log10(gain) for positive gains (error below 0.01 dB) */
+    [[nodiscard]] static float fastGainToDecibels(float gain) noexcept;
+
+    /** Rebuild the static curve after the smoothed parameters moved (not per sub-block) */
+    void updateCurve() noexcept;
 
     //==============================================================================
     const Parameters& parameters;
 
-    // Envelope follower state
-    double envelope = 0.0;
+    // Shared dB -> gain table (one copy per process)
+    std::shared_ptr<const SharedTables::DecibelTable> decibelTable;
+
+    // Envelope follower state, one per lane (in the units of the detector domain)
+    alignas(16) double envelope[numLanes] = {};
+    alignas(16) double peakStage[numLanes] = {};             // Two-stage detectors only
+
+    // Detector topology
+    bool midSide = false;
+    Detector detector = Detector::branching;
+    DetectorDomain domain = DetectorDomain::linear;
+    int kernelIndex = 0;
+
+    // Quality tier state
+    Quality quality = Quality::standard;
+    float previousGain[numLanes] = { 1.0f, 1.0f };          // Last curve gain (eco interpolation start)
+    bool gainsWanted = true;                                // False while analysing: Eco skips the per-sample ramp
+    float oversamplingHistory[numLanes][3] = {};            // x[n-3], x[n-2], x[n-1]
 
     // Smoothed parameter values (to prevent zipper noise)
     float smoothedThreshold = -20.0f;
@@ -45,21 +258,65 @@ private:
     float smoothedKnee = 6.0f;
     float smoothedMix = 1.0f;
     float smoothedMakeup = 1.0f;
+    float smoothedLink = 1.0f;
+    float smoothedExpanderThreshold = -60.0f;
+    float smoothedExpanderRatio = 1.0f;
+    float smoothedUpwardRatio = 1.0f;
+    StaticCurve smoothedCurve;          // From the smoothed values above
     double smoothedAttackCoeff = 0.01;
     double smoothedReleaseCoeff = 0.001;
-    
+
+    // Program-dependent release (releaseCoeffInUse follows smoothedReleaseCoeff when off)
+    bool autoReleaseActive = false;
+    double releaseCoeffInUse = 0.001;
+    double slowAttackCoeff = 0.0;
+    double slowReleaseCoeff = 0.0;
+    alignas(16) double slowEnvelope[numLanes] = {};
+    double crestPeak = 0.0;             // Peak follower of the loudest lane
+    double crestMeanSquare = 0.0;       // Mean square follower of the loudest lane
+    double crestPeakCoeff = 0.0;
+    double crestMeanSquareCoeff = 0.0;
+    float lastMinGainReduction = 1.0f;
+
+    static constexpr double crestPeakReleaseMs = 500.0;
+    static constexpr double crestAveragingMs = 300.0;
+    static constexpr double slowAttackScale = 2.0;      // Slow stage times relative to the adaptive release
+    static constexpr double slowReleaseScale = 5.0;
+
+    // Link amounts above this use the single-detector linked path (L/R only)
+    static constexpr float fullyLinkedThreshold = 0.999f;
+
     // Batch smoothing: update every N samples for efficiency
-    static constexpr int smoothingInterval = 32;
+    static constexpr int smoothingInterval = maxSubBlockSize;
     int smoothingCounter = 0;
 
-public:
-    /** Get smoothed mix value (0-1) - call once per sample after computeGainReduction */
-    [[nodiscard]] float getSmoothedMix() const noexcept { return smoothedMix; }
-    
-    /** Get smoothed makeup gain (linear) - call once per sample after computeGainReduction */
-    [[nodiscard]] float getSmoothedMakeup() const noexcept { return smoothedMakeup; }
+    // Preset morph: per-sample linear steps towards the new targets, applied per sub-block
+    struct MorphSteps
+    {
+        float threshold = 0.0f;
+        float ratio = 0.0f;
+        float knee = 0.0f;
+        float mix = 0.0f;
+        float makeup = 0.0f;
+        float link = 0.0f;
+        float expanderThreshold = 0.0f;
+        float expanderRatio = 0.0f;
+        float upwardRatio = 0.0f;
+        double attackCoeff = 0.0;
+        double releaseCoeff = 0.0;
+    };
+
+    MorphSteps morphSteps;
+    int morphSamplesRemaining = 0;
+
+    // Detector update while bypassed: peaks of the sub-block so far and its decimated coefficients
+    float bypassPeak[numLanes] = {};
+    int bypassPeakSamples = 0;
+    double bypassAttackCoeff = -1.0;
+    double bypassReleaseCoeff = -1.0;
+    double bypassAttackFull = 0.0;
+    double bypassReleaseFull = 0.0;
 
-private:
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Compressor)
 };
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Detector topology policies for FIDI Comp
+ * Compile-time building blocks for the compressor's detector kernels. Each
+ * combination of one detector, one domain and one topology is instantiated
+ * as its own kernel, so the choice costs nothing inside the sample loops.
+ * Coefficients are one-pole poles: state = coeff * (state - target) + target.
+ */
+namespace DetectorPolicies
+{
+    //==============================================================================
+    /**
+     * Both detector lanes (L/R or M/S) in one SIMD register, lane 0 in element 0.
+     * Elements past the second, on wider registers, carry copies and are ignored.
+     */
+    using Lanes = juce::dsp::SIMDRegister<double>;
+
+    static_assert(Lanes::SIMDNumElements >= 2, "Both detector lanes need to fit in one register");
+
+    /** Register holding one value per lane */
+    inline Lanes loadLanes(double lane0, double lane1) noexcept
+    {
+        alignas(Lanes::SIMDRegisterSize) double values[Lanes::SIMDNumElements];
+        std::fill(std::begin(values), std::end(values), lane1);
+        values[0] = lane0;
+        return Lanes::fromRawArray(values);
+    }
+
+    //==============================================================================
+    // Detectors: one envelope step for an input in the domain's units. Two-stage
+    // detectors keep their peak stage in the second state. step() advances one
+    // lane, stepLanes() both at once with the attack/release choice as a mask.
+
+    /** Attack or release chosen per sample by whether the input is above the envelope */
+    struct Branching
+    {
+        static double step(double input, double& state, double& peak,
+                           double attack, double release, double floor) noexcept
+        {
+            juce::ignoreUnused(peak);
+            const double coeff = input > state ? attack : release;
+            state = std::max(coeff * (state - input) + input, floor);
+            return state;
+        }
+
+        static Lanes stepLanes(Lanes input, Lanes& state, Lanes& peak,
+                               Lanes attack, Lanes release, Lanes floor) noexcept
+        {
+            juce::ignoreUnused(peak);
+            const auto attacking = Lanes::greaterThan(input, state);
+            const Lanes coeff = (attack & attacking) + (release & ~attacking);
+            state = Lanes::max(coeff * (state - input) + input, floor);
+            return state;
+        }
+    };
+
+    /** Peak hold that releases towards the floor, then an attack smoother on top */
+    struct Decoupled
+    {
+        static double step(double input, double& state, double& peak,
+                           double attack, double release, double floor) noexcept
+        {
+            peak = std::max(input, release * (peak - floor) + floor);
+            state = attack * (state - peak) + peak;
+            return state;
+        }
+
+        static Lanes stepLanes(Lanes input, Lanes& state, Lanes& peak,
+                               Lanes attack, Lanes release, Lanes floor) noexcept
+        {
+            peak = Lanes::max(input, release * (peak - floor) + floor);
+            state = attack * (state - peak) + peak;
+            return state;
+        }
+    };
+
+    /** Like Decoupled, but the peak stage releases towards the input, so it stays level-corrected */
+    struct SmoothPeak
+    {
+        static double step(double input, double& state, double& peak,
+                           double attack, double release, double floor) noexcept
+        {
+            peak = std::max(input, release * (peak - input) + input);
+            state = std::max(attack * (state - peak) + peak, floor);
+            return state;
+        }
+
+        static Lanes stepLanes(Lanes input, Lanes& state, Lanes& peak,
+                               Lanes attack, Lanes release, Lanes floor) noexcept
+        {
+            peak = Lanes::max(input, release * (peak - input) + input);
+            state = Lanes::max(attack * (state - peak) + peak, floor);
+            return state;
+        }
+    };
+
+    //==============================================================================
+    // Domains: what the detector smooths
+
+    /** Linear level; the gain computer converts the envelope to dB */
+    struct LinearDomain
+    {
+        static constexpr bool isLog = false;
+        static constexpr double floor = 0.0;
+
+        static double fromLinear(double level) noexcept { return level; }
+    };
+
+    /** Level in dB (attack and release become linear ramps in dB); the gain computer skips its log */
+    struct LogDomain
+    {
+        static constexpr bool isLog = true;
+        static constexpr double floor = -100.0;
+
+        static double fromLinear(double level) noexcept
+        {
+            return std::max(20.0 * std::log10(std::max(level, 1.0e-10)), floor);
+        }
+
+        static double toLinear(double levelDb) noexcept
+        {
+            return levelDb > floor ? std::pow(10.0, levelDb / 20.0) : 0.0;
+        }
+    };
+
+    //==============================================================================
+    // Topologies: where the detector listens
+
+    /** Detector on the input level */
+    struct FeedForward
+    {
+        static constexpr bool isFeedback = false;
+    };
+
+    /** Detector on the output level (input times the previous sample's gain reduction) */
+    struct Feedback
+    {
+        static constexpr bool isFeedback = true;
+    };
+}
@@ -0,0 +1,111 @@
+#include "GainReductionStats.h"
+
+//==============================================================================
+void GainReductionStats::add(float minGain, int count) noexcept
+{
+    if (resetPending.load(std::memory_order_relaxed) && resetPending.exchange(false))
+        clear();
+
+    // Upward gain (above 1) counts as no reduction
+    const float reductionDb = minGain < 1.0f ? -20.0f * std::log10(std::max(minGain, 1.0e-6f)) : 0.0f;
+    const int bin = juce::jmin(numBins - 1, static_cast<int>(reductionDb / binWidthDb));
+    const auto samples = static_cast<juce::uint64>(count);
+
+    addRelaxed(histogram[static_cast<size_t>(bin)], samples);
+    addRelaxed(numSamples, samples);
+    addRelaxed(sumDb, static_cast<double>(reductionDb) * count);
+
+    if (reductionDb >= compressingThresholdDb)
+        addRelaxed(numSamplesCompressing, samples);
+
+    if (reductionDb > peakDb.load(std::memory_order_relaxed))
+        peakDb.store(reductionDb, std::memory_order_relaxed);
+
+    if (envelopeInterval > 0)
+    {
+        envelopeMinGain = std::min(envelopeMinGain, minGain);
+        envelopePosition += count;
+
+        if (envelopePosition >= envelopeInterval)
+        {
+            envelope.push_back(envelopeMinGain < 1.0f ? -20.0f * std::log10(std::max(envelopeMinGain, 1.0e-6f)) : 0.0f);
+            envelopePosition -= envelopeInterval;
+            envelopeMinGain = 1.0f;
+        }
+    }
+}
+
+void GainReductionStats::clear() noexcept
+{
+    for (auto& bin : histogram)
+        bin.store(0, std::memory_order_relaxed);
+
+    numSamples.store(0, std::memory_order_relaxed);
+    numSamplesCompressing.store(0, std::memory_order_relaxed);
+    sumDb.store(0.0, std::memory_order_relaxed);
+    peakDb.store(0.0f, std::memory_order_relaxed);
+
+    envelope.clear();
+    envelopePosition = 0;
+    envelopeMinGain = 1.0f;
+}
+
+//==============================================================================
+double GainReductionStats::Summary::getCompressingFraction() const noexcept
+{
+    return numSamples > 0 ? static_cast<double>(numSamplesCompressing) / static_cast<double>(numSamples) : 0.0;
+}
+
+GainReductionStats::Summary GainReductionStats::getSummary() const noexcept
+{
+    Summary summary;
+    summary.numSamples = numSamples.load(std::memory_order_relaxed);
+    summary.numSamplesCompressing = numSamplesCompressing.load(std::memory_order_relaxed);
+    summary.peakDb = peakDb.load(std::memory_order_relaxed);
+
+    if (summary.numSamples > 0)
+        summary.averageDb = static_cast<float>(sumDb.load(std::memory_order_relaxed) / static_cast<double>(summary.numSamples));
+
+    for (size_t i = 0; i < histogram.size(); ++i)
+        summary.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+
+    return summary;
+}
+
+//==============================================================================
+void GainReductionStats::enableEnvelope(int samplesPerPoint, juce::int64 expectedSamples)
+{
+    envelopeInterval = juce::jmax(1, samplesPerPoint);
+    envelope.clear();
+    envelope.reserve(static_cast<size_t>(expectedSamples / envelopeInterval + 1));
+    envelopePosition = 0;
+    envelopeMinGain = 1.0f;
+}
+
+bool GainReductionStats::writeEnvelopeCsv(juce::OutputStream& output, double sampleRate) const
+{
+    const double secondsPerPoint = static_cast<double>(envelopeInterval) / sampleRate;
+    bool ok = output.writeText("time_s,gr_db\n", false, false, nullptr);
+
+    for (size_t i = 0; i < envelope.size() && ok; ++i)
+        ok = output.writeText(juce::String(static_cast<double>(i) * secondsPerPoint, 4) + ","
+                                  + juce::String(envelope[i], 2) + "\n",
+                              false, false, nullptr);
+
+    return ok;
+}
+
+bool GainReductionStats::writeEnvelopeBinary(juce::OutputStream& output, double sampleRate) const
+{
+    bool ok = output.writeInt(static_cast<int>(envelopeMagic))
+           && output.writeShort(static_cast<short>(envelopeVersion))
+           && output.writeShort(0)
+           && output.writeDouble(sampleRate)
+           && output.writeInt(envelopeInterval)
+           && output.writeInt(static_cast<int>(envelope.size()));
+
+    for (size_t i = 0; i < envelope.size() && ok; ++i)
+        ok = output.writeFloat(envelope[i]);
+
+    return ok;
+}
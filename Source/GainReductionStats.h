@@ -0,0 +1,95 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Gain reduction statistics for FIDI Comp
+ * Collects one value per compressor sub-block (its deepest reduction): a
+ * histogram in 0.5 dB bins, time in compression, peak and average gain
+ * reduction, and optionally a decimated envelope for export as CSV or a
+ * compact binary file. Counters are relaxed atomics with a single writer
+ * (the audio thread, or the offline analysis), so the editor can read them
+ * at any time.
+ */
+class GainReductionStats
+{
+public:
+    //==============================================================================
+    static constexpr float binWidthDb = 0.5f;
+    static constexpr int numBins = 96;                   // 0 to 48 dB, deeper reduction lands in the last bin
+    static constexpr float compressingThresholdDb = 0.1f; // Reduction counted as time in compression
+
+    GainReductionStats() = default;
+
+    //==============================================================================
+    /**
+     * Add one sub-block (writer thread only).
+     * @param minGain Deepest gain reduction in the sub-block (1.0 = none)
+     */
+    void add(float minGain, int numSamples) noexcept;
+
+    /** Clear the statistics before the writer's next add (any thread) */
+    void reset() noexcept { resetPending.store(true); }
+
+    //==============================================================================
+    struct Summary
+    {
+        juce::uint64 numSamples = 0;
+        juce::uint64 numSamplesCompressing = 0;
+        float peakDb = 0.0f;            // Deepest reduction, positive dB
+        float averageDb = 0.0f;         // Mean reduction over all samples, positive dB
+        std::array<juce::uint64, numBins> histogram{};   // Samples per 0.5 dB bin
+
+        [[nodiscard]] double getSeconds(double sampleRate) const noexcept { return static_cast<double>(numSamples) / sampleRate; }
+        [[nodiscard]] double getCompressingFraction() const noexcept;
+    };
+
+    /** Current statistics (any thread) */
+    [[nodiscard]] Summary getSummary() const noexcept;
+
+    //==============================================================================
+    /**
+     * Record the deepest reduction per interval for export (not on the audio thread:
+     * reserves room for the expected length up front).
+     */
+    void enableEnvelope(int samplesPerPoint, juce::int64 expectedSamples);
+
+    /** "time_s,gr_db" lines, one per envelope point */
+    bool writeEnvelopeCsv(juce::OutputStream& output, double sampleRate) const;
+
+    /** Little-endian: 'FDGR' magic, uint16 version, uint16 0, float64 sample rate, uint32 samples per point, uint32 count, then float32 dB */
+    bool writeEnvelopeBinary(juce::OutputStream& output, double sampleRate) const;
+
+    [[nodiscard]] const std::vector<float>& getEnvelope() const noexcept { return envelope; }
+
+    static constexpr juce::uint32 envelopeMagic = 0x52474446;   // 'F' 'D' 'G' 'R'
+    static constexpr juce::uint16 envelopeVersion = 1;
+
+private:
+    //==============================================================================
+    void clear() noexcept;
+
+    /** Single writer: plain read-modify-write, published with a relaxed store */
+    template <typename T>
+    static void addRelaxed(std::atomic<T>& counter, T amount) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    std::array<std::atomic<juce::uint64>, numBins> histogram{};
+    std::atomic<juce::uint64> numSamples { 0 };
+    std::atomic<juce::uint64> numSamplesCompressing { 0 };
+    std::atomic<double> sumDb { 0.0 };                  // Sample-weighted sum of reduction in dB
+    std::atomic<float> peakDb { 0.0f };
+    std::atomic<bool> resetPending { false };
+
+    // Decimated envelope (offline analysis only)
+    std::vector<float> envelope;
+    int envelopeInterval = 0;           // 0 = not recording
+    int envelopePosition = 0;
+    float envelopeMinGain = 1.0f;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GainReductionStats)
+};
@@ -0,0 +1,108 @@
+#include "Limiter.h"
+
+//==============================================================================
+void Limiter::prepare(double sampleRate, int numChannels)
+{
+    chunkSize = getChunkSize(sampleRate);
+    numPreparedChannels = juce::jmax(1, numChannels);
+    delayBuffer.setSize(numPreparedChannels, 2 * chunkSize);
+
+    // Release applied once per chunk: one-pole towards unity
+    releaseAmount = static_cast<float>(1.0 - std::exp(-static_cast<double>(chunkSize)
+                                                      / (sampleRate * releaseSeconds)));
+
+    reset();
+}
+
+void Limiter::reset() noexcept
+{
+    delayBuffer.clear();
+    chunkPosition = 0;
+    writePosition = 0;
+    incomingPeak = 0.0f;
+    newerPeak = 0.0f;
+    olderPeak = 0.0f;
+    gain = 1.0f;
+    gainStep = 0.0f;
+    chunkTargetGain = 1.0f;
+}
+
+void Limiter::resetGain() noexcept
+{
+    gain = 1.0f;
+    gainStep = 0.0f;
+    chunkTargetGain = 1.0f;
+}
+
+//==============================================================================
+void Limiter::beginChunk(bool enabled, float ceilingLinear) noexcept
+{
+    olderPeak = newerPeak;
+    newerPeak = incomingPeak;
+    incomingPeak = 0.0f;
+
+    // The chunk about to be output is "older"; ending its ramp at the minimum with
+    // "newer" means the next chunk already starts at or below its own required gain
+    const float peak = std::max(olderPeak, newerPeak);
+    float target = (enabled && peak > ceilingLinear) ? ceilingLinear / peak : 1.0f;
+
+    // Release: only move part of the way back up (still never above the required gain)
+    if (target > gain)
+        target = gain + (target - gain) * releaseAmount;
+
+    chunkTargetGain = target;
+    gainStep = (target - gain) / static_cast<float>(chunkSize);
+}
+
+//==============================================================================
+void Limiter::process(float* const* channels, int numChannels, int numSamples,
+                      bool enabled, float ceilingLinear) noexcept
+{
+    numChannels = juce::jmin(numChannels, numPreparedChannels);
+
+    for (int start = 0; start < numSamples;)
+    {
+        if (chunkPosition == 0)
+            beginChunk(enabled, ceilingLinear);
+
+        const int segmentSize = juce::jmin(numSamples - start, chunkSize - chunkPosition);
+
+        // Vectorised peak scan of the incoming audio
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(channels[ch] + start, segmentSize);
+            incomingPeak = std::max(incomingPeak, std::max(-range.getStart(), range.getEnd()));
+        }
+
+        // Delay by two chunks and apply the gain ramp. The write position stays chunk
+        // aligned, so a segment never wraps inside the delay buffer.
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* delayed = delayBuffer.getWritePointer(ch, writePosition);
+            float* audio = channels[ch] + start;
+            float sampleGain = gain;
+
+            for (int i = 0; i < segmentSize; ++i)
+            {
+                const float output = delayed[i] * sampleGain;
+                delayed[i] = audio[i];
+                audio[i] = output;
+                sampleGain += gainStep;
+            }
+        }
+
+        gain += gainStep * static_cast<float>(segmentSize);
+        chunkPosition += segmentSize;
+        writePosition += segmentSize;
+        start += segmentSize;
+
+        if (chunkPosition == chunkSize)
+        {
+            chunkPosition = 0;
+            gain = chunkTargetGain;  // Remove accumulated rounding from the ramp
+
+            if (writePosition == delayBuffer.getNumSamples())
+                writePosition = 0;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Output ceiling limiter for FIDI Comp
+ * Brickwall lookahead limiter that runs after makeup gain. The signal is
+ * delayed by two chunks of ~0.75ms; peaks are scanned one chunk at a time
+ * with vectorised min/max and the gain is ramped linearly per chunk, so the
+ * only per-sample work is the delay and one multiply.
+ * The lookahead delay is always in the signal path (also when the ceiling is
+ * off) so the reported latency never changes.
+ */
+class Limiter
+{
+public:
+    //==============================================================================
+    Limiter() = default;
+
+    //==============================================================================
+    /** Allocate the lookahead delay for the given sample rate and channel count */
+    void prepare(double sampleRate, int numChannels);
+
+    /** Clear the delay line and gain state */
+    void reset() noexcept;
+
+    /** Jump to unity gain, keeping the delay line and peaks (the bypassed path stays unaltered) */
+    void resetGain() noexcept;
+
+    /** Length of the chunks the peaks are scanned and the gain is ramped in, at a sample rate */
+    [[nodiscard]] static int getChunkSize(double sampleRate) noexcept
+    {
+        return juce::jmax(8, juce::roundToInt(sampleRate * chunkSeconds));
+    }
+
+    /** Latency introduced by the lookahead delay */
+    [[nodiscard]] int getLatencySamples() const noexcept { return 2 * chunkSize; }
+
+    /**
+     * Delay the audio by the lookahead and keep its peaks below the ceiling.
+     * @param enabled If false the gain ramps back to unity (audio is still delayed)
+     * @param ceilingLinear Maximum output peak as linear gain
+     */
+    void process(float* const* channels, int numChannels, int numSamples,
+                 bool enabled, float ceilingLinear) noexcept;
+
+private:
+    //==============================================================================
+    /** Shift chunk peaks and set the gain ramp for the chunk about to be output */
+    void beginChunk(bool enabled, float ceilingLinear) noexcept;
+
+    //==============================================================================
+    static constexpr double chunkSeconds = 0.00075;     // Lookahead = 2 chunks = 1.5ms
+    static constexpr double releaseSeconds = 0.060;
+
+    int chunkSize = 32;
+    int numPreparedChannels = 0;
+    juce::AudioBuffer<float> delayBuffer;               // 2 chunks per channel
+    int chunkPosition = 0;
+    int writePosition = 0;
+
+    // Peaks of the chunk being received and of the two chunks in the delay line
+    float incomingPeak = 0.0f;
+    float newerPeak = 0.0f;
+    float olderPeak = 0.0f;
+
+    // Gain ramp for the chunk being output
+    float gain = 1.0f;
+    float gainStep = 0.0f;
+    float chunkTargetGain = 1.0f;
+    float releaseAmount = 0.0f;                         // Fraction of the way back to unity per chunk
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Limiter)
+};
@@ -0,0 +1,110 @@
+#include "LinkGroups.h"
+
+//==============================================================================
+juce::uint64 LinkGroups::pack(float level, juce::uint32 timeMs) noexcept
+{
+    juce::uint32 levelBits;
+    std::memcpy(&levelBits, &level, sizeof(levelBits));
+    return (static_cast<juce::uint64>(timeMs) << 32) | levelBits;
+}
+
+float LinkGroups::unpackLevel(juce::uint64 packed) noexcept
+{
+    const auto levelBits = static_cast<juce::uint32>(packed);
+    float level;
+    std::memcpy(&level, &levelBits, sizeof(level));
+    return level;
+}
+
+juce::uint32 LinkGroups::unpackTime(juce::uint64 packed) noexcept
+{
+    return static_cast<juce::uint32>(packed >> 32);
+}
+
+//==============================================================================
+LinkGroups::Member::~Member()
+{
+    leave();
+}
+
+void LinkGroups::Member::prepare(double sampleRate, int blockSize) noexcept
+{
+    const double blockMilliseconds = sampleRate > 0.0 ? 1000.0 * blockSize / sampleRate : 0.0;
+    staleMilliseconds = std::max(minStaleMilliseconds,
+                                 static_cast<juce::uint32>(std::ceil(staleBlocks * blockMilliseconds)));
+}
+
+void LinkGroups::Member::leave() noexcept
+{
+    if (slot >= 0)
+    {
+        auto& ownSlot = groups.slots[static_cast<size_t>(group - 1)][static_cast<size_t>(slot)];
+        ownSlot.levelAndTime.store(0, std::memory_order_relaxed);
+        ownSlot.inUse.store(false, std::memory_order_release);
+    }
+
+    group = 0;
+    slot = -1;
+}
+
+void LinkGroups::Member::setGroup(int newGroup) noexcept
+{
+    newGroup = juce::jlimit(0, numGroups, newGroup);
+
+    if (newGroup == group)
+        return;
+
+    leave();
+    group = newGroup;
+
+    if (group == 0)
+        return;
+
+    // Claim the first free slot; a full group leaves slot at -1
+    auto& groupSlots = groups.slots[static_cast<size_t>(group - 1)];
+
+    for (int i = 0; i < slotsPerGroup; ++i)
+    {
+        bool expected = false;
+
+        if (groupSlots[static_cast<size_t>(i)].inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        {
+            slot = i;
+            break;
+        }
+    }
+}
+
+//==============================================================================
+float LinkGroups::Member::getGroupLevel() const noexcept
+{
+    if (group == 0)
+        return 0.0f;
+
+    const juce::uint32 now = juce::Time::getMillisecondCounter();
+    const auto& groupSlots = groups.slots[static_cast<size_t>(group - 1)];
+    float groupLevel = 0.0f;
+
+    for (int i = 0; i < slotsPerGroup; ++i)
+    {
+        if (i == slot)
+            continue;
+
+        const juce::uint64 packed = groupSlots[static_cast<size_t>(i)].levelAndTime.load(std::memory_order_relaxed);
+
+        // Unsigned difference handles counter wrap-around; never-written slots are stale too
+        if (packed != 0 && now - unpackTime(packed) <= staleMilliseconds)
+            groupLevel = std::max(groupLevel, unpackLevel(packed));
+    }
+
+    return groupLevel;
+}
+
+void LinkGroups::Member::publish(float level) noexcept
+{
+    if (slot < 0)
+        return;
+
+    auto& ownSlot = groups.slots[static_cast<size_t>(group - 1)][static_cast<size_t>(slot)];
+    ownSlot.levelAndTime.store(pack(level, juce::Time::getMillisecondCounter()), std::memory_order_relaxed);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * In-process detector link groups for FIDI Comp
+ * Instances in the same group share one detector: every member publishes the
+ * peak detector level of each block into its own slot, and every member uses
+ * the loudest level published by the others as a floor for its detector
+ * input. Slots are single 64-bit atomics (level + timestamp), claimed with a
+ * compare-exchange, so joining, publishing and reading are lock-free and never
+ * allocate. Shared by all instances in the process (use via
+ * juce::SharedResourcePointer).
+ *
+ * Timing: a block sees the latest level each other member has finished
+ * publishing. Hosts run tracks on several threads in no fixed order, so that
+ * is the other member's current or previous block - at most one block late.
+ * Slots not refreshed for minStaleMilliseconds, or staleBlocks of the
+ * reader's announced block size if that is longer (stopped or bypassed
+ * instances), are ignored.
+ */
+class LinkGroups
+{
+public:
+    //==============================================================================
+    static constexpr int numGroups = 16;
+    static constexpr int slotsPerGroup = 64;
+    static constexpr juce::uint32 minStaleMilliseconds = 100;
+    static constexpr int staleBlocks = 4;       // Long offline blocks publish rarely
+
+    LinkGroups() = default;
+
+    //==============================================================================
+    /**
+     * One instance's membership. Owned by the processor and only used from the
+     * audio thread; releases its slot on destruction.
+     */
+    class Member
+    {
+    public:
+        explicit Member(LinkGroups& owner) noexcept : groups(owner) {}
+        ~Member();
+
+        /** Derive the stale timeout from the announced block size (not on the audio thread) */
+        void prepare(double sampleRate, int blockSize) noexcept;
+
+        /**
+         * Join a group (1 to numGroups) or leave with 0. Lock-free; does nothing
+         * if the group is unchanged. If a group is full the member still reads
+         * the group level but does not publish its own.
+         */
+        void setGroup(int newGroup) noexcept;
+
+        [[nodiscard]] int getGroup() const noexcept { return group; }
+
+        /** Loudest fresh level published by the other members (0 when not in a group) */
+        [[nodiscard]] float getGroupLevel() const noexcept;
+
+        /** Publish this block's own detector peak (without the group floor, so levels never circulate) */
+        void publish(float level) noexcept;
+
+    private:
+        void leave() noexcept;
+
+        LinkGroups& groups;
+        int group = 0;
+        int slot = -1;
+        juce::uint32 staleMilliseconds = minStaleMilliseconds;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Member)
+    };
+
+private:
+    //==============================================================================
+    /** One cache line per slot so members on different threads never share one */
+    struct alignas(64) Slot
+    {
+        std::atomic<bool> inUse{false};
+        std::atomic<juce::uint64> levelAndTime{0};   // Float bits low, millisecond counter high
+    };
+
+    static_assert(std::atomic<juce::uint64>::is_always_lock_free,
+                  "Link group slots must be lock-free");
+
+    [[nodiscard]] static juce::uint64 pack(float level, juce::uint32 timeMs) noexcept;
+    [[nodiscard]] static float unpackLevel(juce::uint64 packed) noexcept;
+    [[nodiscard]] static juce::uint32 unpackTime(juce::uint64 packed) noexcept;
+
+    //==============================================================================
+    std::array<std::array<Slot, slotsPerGroup>, numGroups> slots;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinkGroups)
+};
@@ -1,4 +1,17 @@
 #include "LookAndFeel.h"
+#include "Trace.h"
+
+//==============================================================================
+FIDIEditorStyle::FIDIEditorStyle()
+    : titleFont(juce::FontOptions(28.0f).withStyle("Bold")),
+      captionFont(juce::FontOptions(10.0f).withStyle("Bold")),
+      sectionFont(juce::FontOptions(9.0f).withStyle("Bold")),
+      smallFont(juce::FontOptions(10.0f)),
+      meterFont(juce::FontOptions(11.0f).withStyle("Bold")),
+      valueArcGradient(juce::Colour(0xff00d4ff), 0.0f, 0.0f, juce::Colour(0xff80eaff), 0.0f, 1.0f, false),
+      knobCentreGradient(juce::Colour(0xff252540), 0.0f, -0.5f, juce::Colour(0xff151520), 0.0f, 1.0f, false)
+{
+}
 
 //==============================================================================
 FIDILookAndFeel::FIDILookAndFeel()
@@ -19,6 +32,20 @@ FIDILookAndFeel::FIDILookAndFeel()
     setColour(juce::TextEditor::highlightColourId, accentColour);
     setColour(juce::TextEditor::highlightedTextColourId, textColour);
     setColour(juce::CaretComponent::caretColourId, accentColour);
+
+    setColour(juce::TextButton::buttonColourId, panelColour);
+    setColour(juce::TextButton::buttonOnColourId, accentColour);
+    setColour(juce::TextButton::textColourOffId, textDimColour);
+    setColour(juce::TextButton::textColourOnId, backgroundColour);
+
+    setColour(juce::ComboBox::backgroundColourId, panelColour);
+    setColour(juce::ComboBox::textColourId, textColour);
+    setColour(juce::ComboBox::outlineColourId, trackColour);
+    setColour(juce::ComboBox::arrowColourId, accentColour);
+    setColour(juce::PopupMenu::backgroundColourId, panelColour);
+    setColour(juce::PopupMenu::textColourId, textColour);
+    setColour(juce::PopupMenu::highlightedBackgroundColourId, accentColour);
+    setColour(juce::PopupMenu::highlightedTextColourId, backgroundColour);
 }
 
 //==============================================================================
@@ -26,6 +53,8 @@ void FIDILookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int widt
                                         float sliderPos, float rotaryStartAngle, float rotaryEndAngle,
                                         juce::Slider& slider)
 {
+    FIDI_TRACE_SCOPE("FIDILookAndFeel::drawRotarySlider");
+
     juce::ignoreUnused(slider);
     
     auto bounds = juce::Rectangle<int>(x, y, width, height).toFloat().reduced(6.0f);
@@ -62,10 +91,9 @@ void FIDILookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int widt
         valueArc.addCentredArc(centreX, centreY, radius - 2.0f, radius - 2.0f,
                                 0.0f, rotaryStartAngle, angle, true);
         
-        // Create gradient for value arc
-        juce::ColourGradient gradient(accentColour, centreX, bounds.getY(),
-                                       accentLightColour, centreX, bounds.getBottom(), false);
-        g.setGradientFill(gradient);
+        // Shared gradient stretched over the knob bounds
+        g.setFillType(juce::FillType(style->valueArcGradient)
+                          .transformed(juce::AffineTransform::scale(1.0f, bounds.getHeight()).translated(0.0f, bounds.getY())));
         g.strokePath(valueArc, juce::PathStrokeType(4.0f, juce::PathStrokeType::curved,
                                                      juce::PathStrokeType::rounded));
     }
@@ -74,11 +102,8 @@ void FIDILookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int widt
     float innerRadius = radius * 0.52f;
     
     // Inner shadow effect
-    juce::ColourGradient innerGradient(
-        juce::Colour(0xff252540), centreX, centreY - innerRadius * 0.5f,
-        juce::Colour(0xff151520), centreX, centreY + innerRadius,
-        false);
-    g.setGradientFill(innerGradient);
+    g.setFillType(juce::FillType(style->knobCentreGradient)
+                      .transformed(juce::AffineTransform::scale(innerRadius).translated(centreX, centreY)));
     g.fillEllipse(centreX - innerRadius, centreY - innerRadius,
                   innerRadius * 2.0f, innerRadius * 2.0f);
     
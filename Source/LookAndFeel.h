@@ -2,9 +2,32 @@
 
 #include <JuceHeader.h>
 
+/**
+ * Fonts and gradients for FIDI Comp editors
+ * Built once per process and shared through SharedResourcePointer, so opening
+ * another editor does not look up typefaces again. Gradients are in unit space
+ * and placed with FillType::transformed().
+ */
+struct FIDIEditorStyle
+{
+    FIDIEditorStyle();
+
+    juce::Font titleFont;           // 28 bold
+    juce::Font captionFont;         // 10 bold: knob and selector captions, status bar titles
+    juce::Font sectionFont;         // 9 bold: section labels, diagnostics
+    juce::Font smallFont;           // 10: readouts, version tag
+    juce::Font meterFont;           // 11 bold: meter caption
+
+    juce::ColourGradient valueArcGradient;      // Vertical, y 0 to 1
+    juce::ColourGradient knobCentreGradient;    // Vertical around a unit radius centre
+
+    JUCE_DECLARE_NON_COPYABLE(FIDIEditorStyle)
+};
+
 /**
  * Custom LookAndFeel for FIDI Comp
- * Provides modern dark theme styling with glow effects.
+ * Provides modern dark theme styling with glow effects. One instance is
+ * shared by every editor in the process.
  */
 class FIDILookAndFeel : public juce::LookAndFeel_V4
 {
@@ -24,6 +47,8 @@ public:
 
 private:
     //==============================================================================
+    juce::SharedResourcePointer<FIDIEditorStyle> style;
+
     // Color palette - vibrant cyan accent
     juce::Colour backgroundColour{0xff0d0d1a};
     juce::Colour panelColour{0xff1a1a2e};
@@ -0,0 +1,363 @@
+#include "LoudnessMeter.h"
+#include "Trace.h"
+
+//==============================================================================
+LoudnessMeter::AnalysisThread::AnalysisThread()
+    : juce::TimeSliceThread("FIDI Comp Loudness")
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+LoudnessMeter::AnalysisThread::~AnalysisThread()
+{
+    stopThread(1000);
+}
+
+//==============================================================================
+LoudnessMeter::LoudnessMeter()
+{
+    prepare(48000.0);
+    analysisThread->addTimeSliceClient(this);
+}
+
+LoudnessMeter::~LoudnessMeter()
+{
+    // Waits for a running analysis slice to finish
+    analysisThread->removeTimeSliceClient(this);
+}
+
+//==============================================================================
+void LoudnessMeter::prepare(double sampleRate)
+{
+    // K-weighting for any sample rate (BS.1770 filters from their analog prototypes)
+    {
+        constexpr double frequency = 1681.974450955533;
+        constexpr double gainDb = 3.999843853973347;
+        constexpr double q = 0.7071752369554196;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        stages[0].b0 = (vh + vb * k / q + k * k) / a0;
+        stages[0].b1 = 2.0 * (k * k - vh) / a0;
+        stages[0].b2 = (vh - vb * k / q + k * k) / a0;
+        stages[0].a1 = 2.0 * (k * k - 1.0) / a0;
+        stages[0].a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    {
+        constexpr double frequency = 38.13547087602444;
+        constexpr double q = 0.5003270373238773;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+
+        stages[1].b0 = 1.0;
+        stages[1].b1 = -2.0;
+        stages[1].b2 = 1.0;
+        stages[1].a1 = 2.0 * (k * k - 1.0) / a0;
+        stages[1].a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    std::fill(&state1[0][0], &state1[0][0] + numStages * maxChannels, 0.0);
+    std::fill(&state2[0][0], &state2[0][0] + numStages * maxChannels, 0.0);
+    std::fill(std::begin(blockEnergy), std::end(blockEnergy), 0.0);
+
+    blockSize = juce::jmax(1, juce::roundToInt(sampleRate * blockSeconds));
+    blockPosition = 0;
+
+    resetIntegration();
+}
+
+//==============================================================================
+void LoudnessMeter::process(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (numChannels <= 0)
+        return;
+
+    // Mono runs the second lane on the same input with zero weight, so both lanes always step together
+    const float* input[maxChannels] = { channels[0], numChannels > 1 ? channels[1] : channels[0] };
+    const double weight[maxChannels] = { 1.0, numChannels > 1 ? 1.0 : 0.0 };
+
+    // Both channels' filter state in one register per delay element, for the whole call
+    ChannelPair b0[numStages], b1[numStages], b2[numStages], a1[numStages], a2[numStages];
+    ChannelPair z1[numStages], z2[numStages];
+
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        const auto& f = stages[static_cast<size_t>(stage)];
+        b0[stage] = ChannelPair::expand(f.b0);
+        b1[stage] = ChannelPair::expand(f.b1);
+        b2[stage] = ChannelPair::expand(f.b2);
+        a1[stage] = ChannelPair::expand(f.a1);
+        a2[stage] = ChannelPair::expand(f.a2);
+        z1[stage] = loadChannelPair(state1[stage]);
+        z2[stage] = loadChannelPair(state2[stage]);
+    }
+
+    ChannelPair energy = loadChannelPair(blockEnergy);
+
+    for (int start = 0; start < numSamples;)
+    {
+        const int count = std::min(numSamples - start, blockSize - blockPosition);
+
+        for (int i = start; i < start + count; ++i)
+        {
+            const double pair[maxChannels] = { input[0][i], input[1][i] };
+            ChannelPair x = loadChannelPair(pair);
+
+            // Transposed direct form II, shelf then high-pass
+            for (int stage = 0; stage < numStages; ++stage)
+            {
+                const ChannelPair y = b0[stage] * x + z1[stage];
+                z1[stage] = b1[stage] * x - a1[stage] * y + z2[stage];
+                z2[stage] = b2[stage] * x - a2[stage] * y;
+                x = y;
+            }
+
+            energy = energy + x * x;
+        }
+
+        storeChannelPair(energy, blockEnergy);
+
+        start += count;
+        blockPosition += count;
+
+        if (blockPosition < blockSize)
+            break;
+
+        // 100ms block complete: mean square summed over channels
+        const double meanSquare = (weight[0] * blockEnergy[0] + weight[1] * blockEnergy[1]) / static_cast<double>(blockSize);
+        blockEnergy[0] = 0.0;
+        blockEnergy[1] = 0.0;
+        energy = ChannelPair::expand(0.0);
+        blockPosition = 0;
+
+        // A full FIFO (analysis thread stalled) drops the block
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 > 0)
+            fifoData[static_cast<size_t>(start1)] = meanSquare;
+
+        fifo.finishedWrite(size1);
+    }
+
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        storeChannelPair(z1[stage], state1[stage]);
+        storeChannelPair(z2[stage], state2[stage]);
+    }
+}
+
+LoudnessMeter::ChannelPair LoudnessMeter::loadChannelPair(const double* values) noexcept
+{
+    // Wider registers repeat the second channel in the spare elements
+    alignas(ChannelPair::SIMDRegisterSize) double elements[ChannelPair::SIMDNumElements];
+    std::fill(std::begin(elements), std::end(elements), values[1]);
+    elements[0] = values[0];
+    return ChannelPair::fromRawArray(elements);
+}
+
+void LoudnessMeter::storeChannelPair(ChannelPair pair, double* values) noexcept
+{
+    values[0] = pair.get(0);
+    values[1] = pair.get(1);
+}
+
+//==============================================================================
+LoudnessMeter::Readings LoudnessMeter::getReadings() const noexcept
+{
+    Readings readings;
+    readings.momentary = momentaryLufs.load();
+    readings.shortTerm = shortTermLufs.load();
+    readings.integrated = integratedLufs.load();
+    readings.range = loudnessRange.load();
+    return readings;
+}
+
+//==============================================================================
+int LoudnessMeter::useTimeSlice()
+{
+    FIDI_TRACE_SCOPE("LoudnessMeter::useTimeSlice");
+
+    const bool reset = resetPending.exchange(false);
+
+    if (reset)
+        clearAnalysis();
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    // Blocks queued before a reset belong to the old measurement
+    if (! reset)
+    {
+        for (int i = 0; i < size1; ++i)
+            analyseBlock(fifoData[static_cast<size_t>(start1 + i)]);
+
+        for (int i = 0; i < size2; ++i)
+            analyseBlock(fifoData[static_cast<size_t>(start2 + i)]);
+    }
+
+    fifo.finishedRead(size1 + size2);
+
+    if (reset || size1 + size2 > 0)
+    {
+        integratedLufs.store(getIntegratedLoudness(momentaryHistogram));
+        loudnessRange.store(getLoudnessRange(shortTermHistogram));
+    }
+
+    return 50;
+}
+
+void LoudnessMeter::analyseBlock(double energy) noexcept
+{
+    recentEnergies[static_cast<size_t>(recentPosition)] = energy;
+    recentPosition = (recentPosition + 1) % shortTermBlocks;
+    ++numBlocksSeen;
+
+    // Mean energy of the newest blocks in the ring
+    auto windowEnergy = [this](int numBlocks)
+    {
+        double sum = 0.0;
+
+        for (int i = 1; i <= numBlocks; ++i)
+            sum += recentEnergies[static_cast<size_t>((recentPosition - i + shortTermBlocks) % shortTermBlocks)];
+
+        return sum / numBlocks;
+    };
+
+    // Momentary: 400ms windows every 100ms (75% overlap), also the gating blocks
+    if (numBlocksSeen >= momentaryBlocks)
+    {
+        const double momentaryEnergy = windowEnergy(momentaryBlocks);
+        momentaryLufs.store(energyToLufs(momentaryEnergy));
+        addToHistogram(momentaryHistogram, momentaryEnergy);
+    }
+
+    // Short-term: 3s windows every 100ms, the loudness range distribution
+    if (numBlocksSeen >= shortTermBlocks)
+    {
+        const double shortTermEnergy = windowEnergy(shortTermBlocks);
+        shortTermLufs.store(energyToLufs(shortTermEnergy));
+        addToHistogram(shortTermHistogram, shortTermEnergy);
+    }
+}
+
+void LoudnessMeter::clearAnalysis() noexcept
+{
+    recentEnergies.fill(0.0);
+    recentPosition = 0;
+    numBlocksSeen = 0;
+    momentaryHistogram.fill({});
+    shortTermHistogram.fill({});
+
+    momentaryLufs.store(noReading);
+    shortTermLufs.store(noReading);
+}
+
+//==============================================================================
+float LoudnessMeter::energyToLufs(double energy) noexcept
+{
+    if (energy <= 0.0)
+        return noReading;
+
+    return juce::jmax(noReading, static_cast<float>(-0.691 + 10.0 * std::log10(energy)));
+}
+
+float LoudnessMeter::getBinLoudness(int bin) noexcept
+{
+    return minLufs + (static_cast<float>(bin) + 0.5f) / binsPerLu;
+}
+
+int LoudnessMeter::getBinIndex(float lufs) noexcept
+{
+    return juce::jlimit(0, numBins, static_cast<int>(std::ceil((lufs - minLufs) * binsPerLu - 0.5f)));
+}
+
+void LoudnessMeter::addToHistogram(Histogram& histogram, double energy) noexcept
+{
+    const float lufs = energyToLufs(energy);
+
+    // Absolute gate
+    if (lufs <= minLufs)
+        return;
+
+    const int bin = juce::jmin(numBins - 1, static_cast<int>((lufs - minLufs) * binsPerLu));
+    ++histogram[static_cast<size_t>(bin)].count;
+    histogram[static_cast<size_t>(bin)].energy += energy;
+}
+
+float LoudnessMeter::getRelativeGate(const Histogram& histogram, float gateLu) noexcept
+{
+    juce::uint64 count = 0;
+    double energy = 0.0;
+
+    for (const auto& bin : histogram)
+    {
+        count += bin.count;
+        energy += bin.energy;
+    }
+
+    if (count == 0)
+        return noReading;
+
+    return energyToLufs(energy / static_cast<double>(count)) - gateLu;
+}
+
+float LoudnessMeter::getIntegratedLoudness(const Histogram& histogram) noexcept
+{
+    const float gate = getRelativeGate(histogram, 10.0f);
+
+    if (gate <= noReading)
+        return noReading;
+
+    juce::uint64 count = 0;
+    double energy = 0.0;
+
+    for (int bin = getBinIndex(gate); bin < numBins; ++bin)
+    {
+        count += histogram[static_cast<size_t>(bin)].count;
+        energy += histogram[static_cast<size_t>(bin)].energy;
+    }
+
+    return count > 0 ? energyToLufs(energy / static_cast<double>(count)) : noReading;
+}
+
+float LoudnessMeter::getLoudnessRange(const Histogram& histogram) noexcept
+{
+    const float gate = getRelativeGate(histogram, 20.0f);
+
+    if (gate <= noReading)
+        return 0.0f;
+
+    const int firstBin = getBinIndex(gate);
+    juce::uint64 count = 0;
+
+    for (int bin = firstBin; bin < numBins; ++bin)
+        count += histogram[static_cast<size_t>(bin)].count;
+
+    if (count == 0)
+        return 0.0f;
+
+    // Bin holding a percentile of the gated distribution
+    auto percentile = [&](double fraction)
+    {
+        const auto target = static_cast<juce::uint64>(std::ceil(fraction * static_cast<double>(count)));
+        juce::uint64 cumulative = 0;
+
+        for (int bin = firstBin; bin < numBins; ++bin)
+        {
+            cumulative += histogram[static_cast<size_t>(bin)].count;
+
+            if (cumulative >= juce::jmax<juce::uint64>(target, 1))
+                return getBinLoudness(bin);
+        }
+
+        return getBinLoudness(numBins - 1);
+    };
+
+    return percentile(0.95) - percentile(0.10);
+}
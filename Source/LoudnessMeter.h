@@ -0,0 +1,148 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * EBU R128 / ITU-R BS.1770 loudness meter for FIDI Comp
+ * The audio thread only runs the K-weighting filters (both channels stepped
+ * together in one SIMD register) and pushes one mean-square energy per 100ms block into a
+ * lock-free FIFO. Gating, integration and the loudness range histogram run
+ * on a low-priority analysis thread shared by every meter in the process.
+ *
+ * Integrated loudness and loudness range are gated from histograms with
+ * 0.1 LU bins, so memory stays fixed however long the measurement runs.
+ */
+class LoudnessMeter : private juce::TimeSliceClient
+{
+public:
+    //==============================================================================
+    static constexpr int maxChannels = 2;
+    static constexpr float noReading = -100.0f;     // Published until enough audio was measured
+
+    LoudnessMeter();
+    ~LoudnessMeter() override;
+
+    //==============================================================================
+    /** Set up the filters for a sample rate and restart the measurement (not on the audio thread) */
+    void prepare(double sampleRate);
+
+    /** K-weight and accumulate a block of audio (audio thread) */
+    void process(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /** Restart integrated loudness and loudness range (any thread) */
+    void resetIntegration() noexcept { resetPending.store(true); }
+
+    //==============================================================================
+    struct Readings
+    {
+        float momentary = noReading;    // LUFS, 400ms window
+        float shortTerm = noReading;    // LUFS, 3s window
+        float integrated = noReading;   // LUFS, gated since the last reset
+        float range = 0.0f;             // LU (LRA)
+    };
+
+    /** Latest results published by the analysis thread */
+    [[nodiscard]] Readings getReadings() const noexcept;
+
+private:
+    //==============================================================================
+    int useTimeSlice() override;
+
+    /** Add one 100ms block energy to the windows and histograms (analysis thread) */
+    void analyseBlock(double energy) noexcept;
+
+    /** Clear the analysis history and histograms (analysis thread) */
+    void clearAnalysis() noexcept;
+
+    //==============================================================================
+    struct HistogramBin
+    {
+        juce::uint32 count = 0;
+        double energy = 0.0;
+    };
+
+    static constexpr float minLufs = -70.0f;        // Absolute gate
+    static constexpr float maxLufs = 10.0f;
+    static constexpr float binsPerLu = 10.0f;
+    static constexpr int numBins = static_cast<int>((maxLufs - minLufs) * binsPerLu);
+
+    using Histogram = std::array<HistogramBin, numBins>;
+
+    static void addToHistogram(Histogram& histogram, double energy) noexcept;
+
+    /** Loudness of a bin centre */
+    [[nodiscard]] static float getBinLoudness(int bin) noexcept;
+
+    /** First bin at or above a loudness */
+    [[nodiscard]] static int getBinIndex(float lufs) noexcept;
+
+    /** Relative gate: loudness of the mean energy in the histogram, minus gateLu */
+    [[nodiscard]] static float getRelativeGate(const Histogram& histogram, float gateLu) noexcept;
+
+    /** BS.1770 integrated loudness: mean energy of the blocks above the -10 LU relative gate */
+    [[nodiscard]] static float getIntegratedLoudness(const Histogram& histogram) noexcept;
+
+    /** EBU Tech 3342 loudness range: 10th to 95th percentile above the -20 LU relative gate */
+    [[nodiscard]] static float getLoudnessRange(const Histogram& histogram) noexcept;
+
+    [[nodiscard]] static float energyToLufs(double energy) noexcept;
+
+    //==============================================================================
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    /** Both channels side by side, so the K-weighting filters step them together */
+    using ChannelPair = juce::dsp::SIMDRegister<double>;
+
+    static_assert(ChannelPair::SIMDNumElements >= maxChannels, "Both channels need to fit in one register");
+
+    [[nodiscard]] static ChannelPair loadChannelPair(const double* values) noexcept;
+    static void storeChannelPair(ChannelPair pair, double* values) noexcept;
+
+    static constexpr int numStages = 2;             // High shelf, then high-pass
+    static constexpr double blockSeconds = 0.1;
+
+    // Audio thread state
+    std::array<Biquad, numStages> stages;
+    alignas(16) double state1[numStages][maxChannels] = {};
+    alignas(16) double state2[numStages][maxChannels] = {};
+    alignas(16) double blockEnergy[maxChannels] = {};
+    int blockSize = 4800;
+    int blockPosition = 0;
+
+    // 100ms block energies, audio thread -> analysis thread
+    static constexpr int fifoSize = 128;
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<double, fifoSize> fifoData{};
+
+    // Analysis thread state
+    static constexpr int momentaryBlocks = 4;
+    static constexpr int shortTermBlocks = 30;
+
+    std::array<double, shortTermBlocks> recentEnergies{};
+    int recentPosition = 0;
+    int numBlocksSeen = 0;
+    Histogram momentaryHistogram{};     // 400ms blocks, for integrated loudness
+    Histogram shortTermHistogram{};     // 3s windows, for loudness range
+
+    // Published results
+    std::atomic<float> momentaryLufs { noReading };
+    std::atomic<float> shortTermLufs { noReading };
+    std::atomic<float> integratedLufs { noReading };
+    std::atomic<float> loudnessRange { 0.0f };
+    std::atomic<bool> resetPending { false };
+
+    /** One low-priority thread for the analysis of every meter in the process */
+    struct AnalysisThread : public juce::TimeSliceThread
+    {
+        AnalysisThread();
+        ~AnalysisThread() override;
+    };
+
+    juce::SharedResourcePointer<AnalysisThread> analysisThread;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
@@ -1,7 +1,9 @@
 #include "Meter.h"
+#include "Trace.h"
 
 Meter::Meter(std::atomic<float>& gainReduction)
-    : gainReductionAtomic(gainReduction)
+    : gainReductionAtomic(gainReduction),
+      colourTable(SharedTables::getMeterColourTable(numSegments))
 {
     // Calculate ballistics coefficients for timer rate
     // Using one-pole filter: coeff = 1 - exp(-1 / (rate * time))
@@ -21,6 +23,8 @@ Meter::~Meter()
 //==============================================================================
 void Meter::timerCallback()
 {
+    FIDI_TRACE_SCOPE("Meter::timerCallback");
+
     // Read and reset atomic value
     float gainReduction = gainReductionAtomic.exchange(1.0f);
     
@@ -42,15 +46,30 @@ void Meter::resized()
 {
 }
 
+void Meter::setBackdropVisible(bool shouldShowBackdrop)
+{
+    if (backdropVisible == shouldShowBackdrop)
+        return;
+
+    backdropVisible = shouldShowBackdrop;
+    repaint();
+}
+
 //==============================================================================
 void Meter::paint(juce::Graphics& g)
 {
+    FIDI_TRACE_SCOPE("Meter::paint");
+
     auto bounds = getLocalBounds().toFloat().reduced(2.0f);
+
+    // Opaque, unless a backdrop has to show through
+    const float backgroundAlpha = backdropVisible ? 0.55f : 1.0f;
+    const float unlitAlpha = backdropVisible ? 0.4f : 1.0f;
     
     // Background with subtle gradient
     juce::ColourGradient bgGradient(
-        juce::Colour(0xff0a0a14), bounds.getX(), bounds.getY(),
-        juce::Colour(0xff0f0f1e), bounds.getX(), bounds.getBottom(),
+        juce::Colour(0xff0a0a14).withAlpha(backgroundAlpha), bounds.getX(), bounds.getY(),
+        juce::Colour(0xff0f0f1e).withAlpha(backgroundAlpha), bounds.getX(), bounds.getBottom(),
         false);
     g.setGradientFill(bgGradient);
     g.fillRoundedRectangle(bounds, 4.0f);
@@ -70,36 +89,8 @@ void Meter::paint(juce::Graphics& g)
     {
         float segmentY = bounds.getY() + i * (segmentHeight + segmentGap);
         
-        // Determine segment color based on position with smooth gradient
-        juce::Colour segmentColour;
-        float position = static_cast<float>(i) / numSegments;
-        
-        if (position < 0.4f)
-        {
-            // Cyan (low GR)
-            segmentColour = juce::Colour(0xff00d4ff);
-        }
-        else if (position < 0.65f)
-        {
-            // Blend cyan to yellow
-            float blend = (position - 0.4f) / 0.25f;
-            segmentColour = juce::Colour(0xff00d4ff).interpolatedWith(
-                juce::Colour(0xffffcc00), blend);
-        }
-        else if (position < 0.8f)
-        {
-            // Blend yellow to orange
-            float blend = (position - 0.65f) / 0.15f;
-            segmentColour = juce::Colour(0xffffcc00).interpolatedWith(
-                juce::Colour(0xffff8800), blend);
-        }
-        else
-        {
-            // Red (high GR)
-            float blend = (position - 0.8f) / 0.2f;
-            segmentColour = juce::Colour(0xffff8800).interpolatedWith(
-                juce::Colour(0xffff4444), blend);
-        }
+        // Segment colour from the shared gradient table
+        const juce::Colour segmentColour = colourTable->getColour(i);
         
         // Determine if this segment is lit
         float segmentBrightness = 0.0f;
@@ -129,7 +120,7 @@ void Meter::paint(juce::Graphics& g)
         else
         {
             // Dim unlit segments
-            g.setColour(juce::Colour(0xff1a1a2e));
+            g.setColour(juce::Colour(0xff1a1a2e).withAlpha(unlitAlpha));
             g.fillRoundedRectangle(segmentX, segmentY, segmentWidth, segmentHeight, 2.0f);
         }
     }
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "SharedTables.h"
 
 /**
  * Gain reduction meter component for FIDI Comp
  * Displays real-time compression activity with smoothed visualization.
+ * With a backdrop (the spectrum overlay) its background and unlit segments
+ * are drawn translucent so the backdrop shows through.
  */
 class Meter : public juce::Component, private juce::Timer
 {
@@ -17,14 +20,21 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
 
+    /** Let a component behind the meter show through */
+    void setBackdropVisible(bool shouldShowBackdrop);
+
 private:
     //==============================================================================
     void timerCallback() override;
 
     //==============================================================================
     std::atomic<float>& gainReductionAtomic;
+
+    // Segment colours shared by every meter in the process
+    std::shared_ptr<const SharedTables::MeterColourTable> colourTable;
     
     float displayValue = 0.0f;  // Current display value in dB (0 to maxDb)
+    bool backdropVisible = false;
     
     // Meter ballistics - calculated for 30fps timer rate
     float attackCoeff = 0.3f;    // Fast attack for responsiveness
@@ -0,0 +1,272 @@
+#include "OfflineRenderer.h"
+#include "PluginProcessor.h"
+
+#include <numeric>
+
+//==============================================================================
+OfflineRenderer::Report OfflineRenderer::render(const juce::MemoryBlock& state, const juce::AudioBuffer<float>& input,
+                                                juce::AudioBuffer<float>& output, double sampleRate,
+                                                const Options& options)
+{
+    FIDI_TRACE_SCOPE("OfflineRenderer::render");
+
+    Report report;
+    const int numChannels = input.getNumChannels();
+    const int numSamples = input.getNumSamples();
+
+    if (sampleRate <= 0.0 || options.blockSize <= 0 || options.segmentSeconds <= 0.0)
+        return report;
+
+    output.setSize(numChannels, numSamples);
+    const Job job { state, input, output.getArrayOfWritePointers(), sampleRate, options.blockSize };
+
+    // One instance up front validates the layout and reads the release settings
+    {
+        FIDICompProcessor probe;
+
+        if (! prepareProcessor(probe, job))
+            return report;
+
+        report.preRollSeconds = getPreRollSeconds(probe);
+    }
+
+    report.succeeded = true;
+
+    if (numSamples == 0)
+        return report;
+
+    // Segments, each starting early by the pre-roll (the first one needs none). Both are
+    // whole processing periods, so every instance starts in phase with a serial render.
+    const int period = getProcessingPeriod(sampleRate);
+    const int segmentLength = juce::jmax(1, juce::roundToInt(options.segmentSeconds * sampleRate) / period) * period;
+    const int preRoll = (juce::roundToInt(report.preRollSeconds * sampleRate) + period - 1) / period * period;
+    const int overlapLength = juce::jmax(0, juce::roundToInt(options.verifySeconds * sampleRate));
+
+    std::vector<Segment> segments(static_cast<size_t>((numSamples + segmentLength - 1) / segmentLength));
+    std::vector<Segment*> pending;
+
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        auto& segment = segments[i];
+        segment.start = static_cast<int>(i) * segmentLength;
+        segment.end = juce::jmin(numSamples, segment.start + segmentLength);
+        segment.preRoll = juce::jmin(preRoll, segment.start);
+
+        // The last segment has no seam to verify
+        const int overlap = juce::jmin(overlapLength, numSamples - segment.end);
+        segment.overlap.setSize(numChannels, overlap);
+
+        pending.push_back(&segment);
+    }
+
+    report.numSegments = static_cast<int>(segments.size());
+
+    const int numThreads = options.numThreads > 0 ? options.numThreads : juce::SystemStats::getNumCpus();
+
+    while (! pending.empty())
+    {
+        renderInParallel(job, pending, numThreads);
+        pending.clear();
+
+        // Verify every seam; a failing one renders its second segment again with twice the
+        // pre-roll, up to maxRetries times. A pre-roll reaching the start of the buffer makes
+        // the segment equal the serial render, so that seam cannot fail.
+        report.maxSeamError = 0.0f;
+        report.numFailedSeams = 0;
+
+        for (size_t i = 0; i + 1 < segments.size(); ++i)
+        {
+            const float error = getSeamError(segments[i], job.output);
+            auto& next = segments[i + 1];
+
+            if (error <= options.maxSeamError || next.preRoll >= next.start)
+            {
+                report.maxSeamError = juce::jmax(report.maxSeamError, error);
+            }
+            else if (next.numRetries < options.maxRetries)
+            {
+                next.preRoll = juce::jmin(next.start, juce::jmax(period, next.preRoll * 2));
+                ++next.numRetries;
+                pending.push_back(&next);
+            }
+            else
+            {
+                report.maxSeamError = juce::jmax(report.maxSeamError, error);
+                ++report.numFailedSeams;
+            }
+        }
+
+        report.numRerenders += static_cast<int>(pending.size());
+    }
+
+    report.succeeded = report.numFailedSeams == 0;
+    return report;
+}
+
+//==============================================================================
+bool OfflineRenderer::analyse(const juce::MemoryBlock& state, const juce::AudioBuffer<float>& input,
+                              double sampleRate, GainReductionStats& stats, int blockSize)
+{
+    FIDI_TRACE_SCOPE("OfflineRenderer::analyse");
+
+    if (sampleRate <= 0.0 || blockSize <= 0)
+        return false;
+
+    const Job job { state, input, nullptr, sampleRate, blockSize };
+    FIDICompProcessor processor;
+
+    if (! prepareProcessor(processor, job))
+        return false;
+
+    // Reads the input in place: no copies, nothing is written
+    const int numChannels = input.getNumChannels();
+    const int numSamples = input.getNumSamples();
+    std::array<const float*, 2> channels{};
+
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[static_cast<size_t>(ch)] = input.getReadPointer(ch, start);
+
+        processor.analyseBlock(channels.data(), numChannels, juce::jmin(blockSize, numSamples - start), stats);
+    }
+
+    processor.releaseResources();
+    return true;
+}
+
+//==============================================================================
+double OfflineRenderer::getPreRollSeconds(FIDICompProcessor& processor)
+{
+    auto& apvts = processor.getAPVTS();
+    const double releaseSeconds = apvts.getRawParameterValue("release")->load() * 0.001;
+    const bool autoRelease = apvts.getRawParameterValue("autoRelease")->load() >= 0.5f;
+
+    // A converging envelope's error decays with the release time constant
+    const double slowestRelease = releaseSeconds * (autoRelease ? autoReleaseScale : 1.0);
+    return juce::jmax(minPreRollSeconds, convergenceTimeConstants * slowestRelease);
+}
+
+int OfflineRenderer::getProcessingPeriod(double sampleRate) noexcept
+{
+    // Sub-blocks and Eco control periods restart with each instance, and so do limiter chunks
+    return std::lcm(std::lcm(Compressor::maxSubBlockSize, Compressor::controlInterval),
+                    Limiter::getChunkSize(sampleRate));
+}
+
+//==============================================================================
+bool OfflineRenderer::prepareProcessor(FIDICompProcessor& processor, const Job& job)
+{
+    const int numChannels = job.input.getNumChannels();
+    const auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+
+    if (numChannels == 0 || ! processor.setBusesLayout(layout))
+        return false;
+
+    if (job.state.getSize() > 0)
+        processor.setStateInformation(job.state.getData(), static_cast<int>(job.state.getSize()));
+
+    // Segments must not link to each other, or to instances running in a session
+    if (auto* linkGroup = processor.getAPVTS().getParameter("linkGroup"))
+        linkGroup->setValueNotifyingHost(0.0f);
+
+    processor.setNonRealtime(true);
+    processor.setRateAndBufferSizeDetails(job.sampleRate, job.blockSize);
+    processor.prepareToPlay(job.sampleRate, job.blockSize);
+    return true;
+}
+
+//==============================================================================
+void OfflineRenderer::renderSegment(const Job& job, Segment& segment)
+{
+    FIDI_TRACE_SCOPE("OfflineRenderer::renderSegment");
+
+    FIDICompProcessor processor;
+    const bool prepared = prepareProcessor(processor, job);
+    jassertquiet(prepared);  // Checked by render() with the same layout
+
+    const int numChannels = job.input.getNumChannels();
+    const int numSamples = job.input.getNumSamples();
+    const int latency = processor.getLatencySamples();
+    const int overlapEnd = segment.end + segment.overlap.getNumSamples();
+
+    juce::AudioBuffer<float> block(numChannels, job.blockSize);
+    juce::MidiBuffer midi;
+
+    float* const* overlap = segment.overlap.getArrayOfWritePointers();
+
+    // Copy the part of a processed block that lands in [rangeStart, rangeEnd) of a destination
+    auto copyOverlapping = [&](int blockOutputStart, int rangeStart, int rangeEnd,
+                               float* const* destination, int destinationStart)
+    {
+        const int from = juce::jmax(blockOutputStart, rangeStart);
+        const int to = juce::jmin(blockOutputStart + job.blockSize, rangeEnd);
+
+        for (int ch = 0; ch < numChannels && to > from; ++ch)
+            juce::FloatVectorOperations::copy(destination[ch] + (from - destinationStart),
+                                              block.getReadPointer(ch, from - blockOutputStart), to - from);
+    };
+
+    // Input past the end of the buffer is silence, which flushes the latency
+    for (int position = segment.start - segment.preRoll; position - latency < overlapEnd; position += job.blockSize)
+    {
+        block.clear();
+        const int available = juce::jlimit(0, job.blockSize, numSamples - position);
+
+        for (int ch = 0; ch < numChannels && available > 0; ++ch)
+            block.copyFrom(ch, 0, job.input, ch, position, available);
+
+        processor.processBlock(block, midi);
+
+        // Output sample i of this block belongs to input sample position + i - latency
+        const int blockOutputStart = position - latency;
+        copyOverlapping(blockOutputStart, segment.start, segment.end, job.output, 0);
+        copyOverlapping(blockOutputStart, segment.end, overlapEnd, overlap, segment.end);
+    }
+
+    processor.releaseResources();
+}
+
+void OfflineRenderer::renderInParallel(const Job& job, const std::vector<Segment*>& segments, int numThreads)
+{
+    if (segments.empty())
+        return;
+
+    juce::ThreadPool pool(juce::jmin(numThreads, static_cast<int>(segments.size())));
+    juce::WaitableEvent finished;
+    std::atomic<int> remaining { static_cast<int>(segments.size()) };
+
+    for (auto* segment : segments)
+    {
+        pool.addJob([&job, segment, &finished, &remaining]
+        {
+            renderSegment(job, *segment);
+
+            if (--remaining == 0)
+                finished.signal();
+        });
+    }
+
+    finished.wait();
+}
+
+//==============================================================================
+float OfflineRenderer::getSeamError(const Segment& segment, const float* const* output)
+{
+    float error = 0.0f;
+
+    for (int ch = 0; ch < segment.overlap.getNumChannels(); ++ch)
+    {
+        const float* overlap = segment.overlap.getReadPointer(ch);
+        const float* next = output[ch] + segment.end;
+
+        for (int i = 0; i < segment.overlap.getNumSamples(); ++i)
+            error = std::max(error, std::abs(overlap[i] - next[i]));
+    }
+
+    return error;
+}
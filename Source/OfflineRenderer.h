@@ -0,0 +1,118 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "GainReductionStats.h"
+
+class FIDICompProcessor;
+
+/**
+ * Parallel offline rendering of one long buffer for FIDI Comp
+ * The buffer is split into segments that are rendered concurrently, each by
+ * its own processor instance on a thread pool. Every instance starts early by
+ * a pre-roll long enough for the detectors to converge (derived from the
+ * release time), and its output is trimmed by the reported latency, so the
+ * segments butt together sample-aligned with the input.
+ *
+ * Segment starts and pre-rolls are multiples of the processing period (the
+ * compressor sub-block, the Eco control period and the limiter chunk), so every
+ * instance runs its sub-blocks and chunks in the same phase as a serial render.
+ *
+ * Each segment also renders a short window past its end. Comparing that with
+ * the start of the next segment measures the error at every seam. Seams over
+ * the tolerance are rendered again with twice the pre-roll, a limited number
+ * of times; a seam that still fails makes the render report failure.
+ *
+ * analyse() is the analysis-only path: detectors and gain computer without
+ * applying gain or writing audio, for gain reduction statistics before a
+ * render. Not for use on the audio thread.
+ */
+class OfflineRenderer
+{
+public:
+    //==============================================================================
+    static constexpr int analysisBlockSize = 4096;
+
+    struct Options
+    {
+        double segmentSeconds = 300.0;      // Work per job (the last segment may be shorter)
+        int blockSize = 512;                // Block size passed to processBlock
+        int numThreads = 0;                 // 0 = one per CPU core
+        double verifySeconds = 0.25;        // Overlap compared at each seam
+        float maxSeamError = 1.0e-4f;       // Largest sample difference accepted at a seam (-80 dBFS)
+        int maxRetries = 3;                 // Longer pre-rolls tried per seam before giving up
+    };
+
+    struct Report
+    {
+        bool succeeded = false;             // False for unsupported channel counts or options, or failed seams
+        int numFailedSeams = 0;             // Seams still over the tolerance after maxRetries
+        int numSegments = 0;
+        int numRerenders = 0;               // Segments rendered again with a longer pre-roll
+        float maxSeamError = 0.0f;          // Largest remaining sample difference at any seam
+        double preRollSeconds = 0.0;        // Initial pre-roll per segment
+    };
+
+    //==============================================================================
+    /**
+     * Render input through a processor with the given state into output.
+     * @param state Plugin state from getStateInformation (empty for the defaults)
+     * @param input Mono or stereo audio; not modified
+     * @param output Resized to the input and filled with the latency-trimmed result
+     */
+    static Report render(const juce::MemoryBlock& state, const juce::AudioBuffer<float>& input,
+                         juce::AudioBuffer<float>& output, double sampleRate, const Options& options);
+
+    /**
+     * Collect gain reduction statistics for input without rendering it. Runs
+     * one processor in large blocks with the Eco gain computer, so it is many
+     * times faster than a render. Enable the envelope on stats first to export it.
+     * @return false for unsupported channel counts
+     */
+    static bool analyse(const juce::MemoryBlock& state, const juce::AudioBuffer<float>& input,
+                        double sampleRate, GainReductionStats& stats, int blockSize = analysisBlockSize);
+
+    /** Pre-roll for the current settings of a processor: long enough for its slowest release to settle */
+    [[nodiscard]] static double getPreRollSeconds(FIDICompProcessor& processor);
+
+    /** Samples after which every periodic stage of the processor is back in phase (segments start on multiples) */
+    [[nodiscard]] static int getProcessingPeriod(double sampleRate) noexcept;
+
+private:
+    //==============================================================================
+    struct Segment
+    {
+        int start = 0;                      // First output sample written by this segment
+        int end = 0;                        // One past the last
+        int preRoll = 0;                    // Input rendered (and discarded) before start
+        int numRetries = 0;                 // Times rendered again with a longer pre-roll
+        juce::AudioBuffer<float> overlap;   // Output past end, compared with the next segment
+    };
+
+    struct Job
+    {
+        const juce::MemoryBlock& state;
+        const juce::AudioBuffer<float>& input;
+        float* const* output;               // Taken once up front; jobs write disjoint ranges
+        double sampleRate;
+        int blockSize;
+    };
+
+    /** Apply the state and prepare for rendering; false if the channel layout is not supported */
+    static bool prepareProcessor(FIDICompProcessor& processor, const Job& job);
+
+    /** Render one segment with a fresh processor (writes only its own output range) */
+    static void renderSegment(const Job& job, Segment& segment);
+
+    /** Render the given segments on a pool of threads and wait for all of them */
+    static void renderInParallel(const Job& job, const std::vector<Segment*>& segments, int numThreads);
+
+    /** Largest sample difference between a segment's overlap and the start of the next */
+    [[nodiscard]] static float getSeamError(const Segment& segment, const float* const* output);
+
+    //==============================================================================
+    static constexpr double convergenceTimeConstants = 10.0;   // Residual envelope error e^-10
+    static constexpr double autoReleaseScale = 20.0;           // Slowest auto release stage relative to the knob
+    static constexpr double minPreRollSeconds = 0.5;           // Smoothing and limiter release
+
+    OfflineRenderer() = delete;
+};
@@ -0,0 +1,105 @@
+#include "ParameterUpdateBatcher.h"
+#include "Trace.h"
+
+//==============================================================================
+ParameterUpdateBatcher::ParameterUpdateBatcher(juce::Component& editor)
+    : vBlankAttachment(&editor, [this] { update(); })
+{
+}
+
+ParameterUpdateBatcher::~ParameterUpdateBatcher() = default;
+
+void ParameterUpdateBatcher::attach(juce::RangedAudioParameter& parameter, juce::Slider& slider)
+{
+    jassert(attachments.size() < static_cast<size_t>(maxAttachments));
+
+    const int bit = static_cast<int>(attachments.size());
+    attachments.push_back(std::make_unique<Attachment>(*this, parameter, slider, bit));
+}
+
+void ParameterUpdateBatcher::update()
+{
+    // Nothing changed since the last frame: one atomic load
+    if (dirty.load(std::memory_order_relaxed) == 0)
+        return;
+
+    FIDI_TRACE_SCOPE("ParameterUpdateBatcher::update");
+
+    const auto changed = dirty.exchange(0, std::memory_order_acquire);
+
+    for (size_t i = 0; i < attachments.size(); ++i)
+        if ((changed & (juce::uint64 { 1 } << i)) != 0)
+            attachments[i]->update();
+}
+
+//==============================================================================
+ParameterUpdateBatcher::Attachment::Attachment(ParameterUpdateBatcher& batcher, juce::RangedAudioParameter& rangedParameter,
+                                               juce::Slider& attachedSlider, int bit)
+    : owner(batcher),
+      parameter(rangedParameter),
+      slider(attachedSlider),
+      mask(juce::uint64 { 1 } << bit)
+{
+    // The knob maps, snaps and formats exactly like the parameter
+    const auto& range = parameter.getNormalisableRange();
+    slider.setNormalisableRange({ static_cast<double>(range.start), static_cast<double>(range.end),
+                                  static_cast<double>(range.interval), static_cast<double>(range.skew),
+                                  range.symmetricSkew });
+
+    slider.textFromValueFunction = [this](double value)
+    {
+        return parameter.getText(parameter.convertTo0to1(static_cast<float>(value)), 0);
+    };
+
+    slider.valueFromTextFunction = [this](const juce::String& text)
+    {
+        return static_cast<double>(parameter.convertFrom0to1(parameter.getValueForText(text)));
+    };
+
+    slider.setDoubleClickReturnValue(true, static_cast<double>(parameter.convertFrom0to1(parameter.getDefaultValue())));
+
+    // Drags, double-click resets and typed values all arrive inside drag notifications
+    slider.onDragStart = [this] { parameter.beginChangeGesture(); };
+    slider.onDragEnd = [this] { parameter.endChangeGesture(); };
+    slider.onValueChange = [this]
+    {
+        const float newValue = parameter.convertTo0to1(static_cast<float>(slider.getValue()));
+
+        if (newValue != parameter.getValue())
+            parameter.setValueNotifyingHost(newValue);
+    };
+
+    slider.setValue(static_cast<double>(parameter.convertFrom0to1(parameter.getValue())), juce::dontSendNotification);
+    slider.updateText();
+
+    parameter.addListener(this);
+}
+
+ParameterUpdateBatcher::Attachment::~Attachment()
+{
+    parameter.removeListener(this);
+
+    slider.onDragStart = nullptr;
+    slider.onDragEnd = nullptr;
+    slider.onValueChange = nullptr;
+    slider.textFromValueFunction = nullptr;
+    slider.valueFromTextFunction = nullptr;
+}
+
+void ParameterUpdateBatcher::Attachment::parameterValueChanged(int, float)
+{
+    // Any thread, possibly the audio thread: mark only
+    owner.dirty.fetch_or(mask, std::memory_order_release);
+}
+
+void ParameterUpdateBatcher::Attachment::update()
+{
+    const float value = parameter.getValue();
+
+    // Compared as onValueChange sets it, which also catches the echo of the knob's own edits
+    if (value == parameter.convertTo0to1(static_cast<float>(slider.getValue())))
+        return;
+
+    // No notification, so the value is not sent back to the parameter
+    slider.setValue(static_cast<double>(parameter.convertFrom0to1(value)), juce::dontSendNotification);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Parameter-to-knob updates for FIDI Comp's editor, applied once per frame
+ * Replaces SliderAttachment for the rotary knobs. A parameter change, from
+ * any thread, only sets its bit in an atomic dirty mask. Once per display
+ * frame the editor takes the mask and moves each dirty knob to its
+ * parameter's current value, skipping knobs that already show it, so dense
+ * automation costs one slider update, text format and repaint per knob and
+ * frame at most, and unchanged knobs cost nothing. Knob edits go straight to
+ * the parameter as host gestures, as with SliderAttachment.
+ */
+class ParameterUpdateBatcher
+{
+public:
+    //==============================================================================
+    /** Updates run on the editor's display frames, so only while it is on screen */
+    explicit ParameterUpdateBatcher(juce::Component& editor);
+    ~ParameterUpdateBatcher();
+
+    /** Connect a knob to a parameter; takes over its range, text conversion and double-click value */
+    void attach(juce::RangedAudioParameter& parameter, juce::Slider& slider);
+
+    static constexpr int maxAttachments = 64;   // One bit each in the dirty mask
+
+private:
+    //==============================================================================
+    /** One knob and its parameter */
+    class Attachment : private juce::AudioProcessorParameter::Listener
+    {
+    public:
+        Attachment(ParameterUpdateBatcher& owner, juce::RangedAudioParameter& parameter, juce::Slider& slider, int bit);
+        ~Attachment() override;
+
+        /** Move the knob to the parameter's value unless it already shows it (message thread) */
+        void update();
+
+    private:
+        void parameterValueChanged(int parameterIndex, float newValue) override;
+        void parameterGestureChanged(int, bool) override {}
+
+        ParameterUpdateBatcher& owner;
+        juce::RangedAudioParameter& parameter;
+        juce::Slider& slider;
+        const juce::uint64 mask;
+
+        JUCE_DECLARE_NON_COPYABLE(Attachment)
+    };
+
+    /** Apply every change since the last frame (message thread) */
+    void update();
+
+    //==============================================================================
+    std::vector<std::unique_ptr<Attachment>> attachments;
+    std::atomic<juce::uint64> dirty { 0 };
+    juce::VBlankAttachment vBlankAttachment;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterUpdateBatcher)
+};
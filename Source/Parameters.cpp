@@ -1,4 +1,5 @@
 #include "Parameters.h"
+#include "Trace.h"
 
 //==============================================================================
 Parameters::Parameters(juce::AudioProcessorValueTreeState& apvts)
@@ -6,16 +7,42 @@ Parameters::Parameters(juce::AudioProcessorValueTreeState& apvts)
       ratioParam(*apvts.getRawParameterValue("ratio")),
       attackParam(*apvts.getRawParameterValue("attack")),
       releaseParam(*apvts.getRawParameterValue("release")),
+      autoReleaseParam(*apvts.getRawParameterValue("autoRelease")),
       kneeParam(*apvts.getRawParameterValue("knee")),
       makeupParam(*apvts.getRawParameterValue("makeup")),
-      mixParam(*apvts.getRawParameterValue("mix"))
+      autoMakeupParam(*apvts.getRawParameterValue("autoMakeup")),
+      mixParam(*apvts.getRawParameterValue("mix")),
+      expanderThresholdParam(*apvts.getRawParameterValue("expThreshold")),
+      expanderRatioParam(*apvts.getRawParameterValue("expRatio")),
+      upwardRatioParam(*apvts.getRawParameterValue("upwardRatio")),
+      linkParam(*apvts.getRawParameterValue("link")),
+      stereoModeParam(*apvts.getRawParameterValue("stereoMode")),
+      linkGroupParam(*apvts.getRawParameterValue("linkGroup")),
+      qualityParam(*apvts.getRawParameterValue("quality")),
+      offlineHighParam(*apvts.getRawParameterValue("offlineHigh")),
+      detectorParam(*apvts.getRawParameterValue("detector")),
+      detectorDomainParam(*apvts.getRawParameterValue("detectorDomain")),
+      topologyParam(*apvts.getRawParameterValue("topology")),
+      limiterParam(*apvts.getRawParameterValue("limiter")),
+      ceilingParam(*apvts.getRawParameterValue("ceiling")),
+      bypassParam(*apvts.getRawParameterValue("bypass")),
+      rawParams(makeRawParams(thresholdParam, ratioParam, attackParam, releaseParam, autoReleaseParam,
+                              kneeParam, makeupParam, autoMakeupParam, mixParam,
+                              expanderThresholdParam, expanderRatioParam, upwardRatioParam,
+                              linkParam, stereoModeParam, linkGroupParam, qualityParam, offlineHighParam,
+                              detectorParam, detectorDomainParam, topologyParam,
+                              limiterParam, ceilingParam, bypassParam))
 {
+    lastRawValues.fill(std::numeric_limits<float>::quiet_NaN());
+    coefficientTable = SharedTables::getCoefficientTable(sampleRate);
+    decibelTable = SharedTables::getDecibelTable();
 }
 
 //==============================================================================
 void Parameters::setSampleRate(double newSampleRate) noexcept
 {
     sampleRate = newSampleRate;
+    coefficientTable = SharedTables::getCoefficientTable(sampleRate);
     
     // Calculate smoothing coefficient for ~30ms smoothing time
     // Note: For smoothing we need (1 - exp) since we use it as a speed coefficient
@@ -24,38 +51,115 @@ void Parameters::setSampleRate(double newSampleRate) noexcept
     smoothingCoeff = 1.0 - std::exp(-1.0 / (sampleRate * 0.030));  // 30ms
     
     // Force update of all coefficients
+    lastRawValues.fill(std::numeric_limits<float>::quiet_NaN());
     update();
 }
 
 //==============================================================================
-[[nodiscard]] double Parameters::calculateCoefficient(double timeMs) const noexcept
+double Parameters::calculateCoefficient(double timeMs) const noexcept
 {
     if (timeMs <= 0.0 || sampleRate <= 0.0)
         return 0.0;
     
     // One-pole filter coefficient: exp(-1 / (sampleRate * timeSeconds))
     // This gives values close to 1.0 for slow (long times) and close to 0.0 for fast (short times)
-    return std::exp(-1.0 / (sampleRate * timeMs * 0.001));
+    // Looked up from the process-wide table for this sample rate instead of calling std::exp
+    return coefficientTable->getCoefficient(timeMs);
 }
 
 //==============================================================================
+bool Parameters::rawValuesChanged() noexcept
+{
+    bool changed = false;
+
+    for (size_t i = 0; i < rawParams.size(); ++i)
+    {
+        const float value = rawParams[i]->load(std::memory_order_relaxed);
+
+        if (value != lastRawValues[i])
+        {
+            lastRawValues[i] = value;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
 void Parameters::update() noexcept
 {
+    FIDI_TRACE_SCOPE("Parameters::update");
+
+    // Unchanged (the usual case): every value below is still current
+    if (! rawValuesChanged())
+        return;
+
     // Read raw parameters
     threshold = thresholdParam.load();
     ratio = ratioParam.load();
     knee = kneeParam.load();
+
+    // Expander and upward compression segments of the static curve
+    expanderThreshold = expanderThresholdParam.load();
+    expanderRatio = expanderRatioParam.load();
+    upwardRatio = upwardRatioParam.load();
     
-    // Convert mix from percentage to 0-1 range
+    // Convert mix and link from percentage to 0-1 range
     mix = mixParam.load() * 0.01f;
+    link = linkParam.load() * 0.01f;
+
+    // Stereo mode choice: 0 = L/R, 1 = M/S
+    midSide = stereoModeParam.load() >= 0.5f;
+
+    // Link group choice: 0 = off, 1-16 = group
+    linkGroup = juce::roundToInt(linkGroupParam.load());
+
+    // Quality tier choice and offline override
+    quality = juce::jlimit(0, 2, juce::roundToInt(qualityParam.load()));
+    offlineHighQuality = offlineHighParam.load() >= 0.5f;
+
+    // Detector topology choices
+    detector = juce::jlimit(0, 2, juce::roundToInt(detectorParam.load()));
+    detectorDomain = juce::jlimit(0, 1, juce::roundToInt(detectorDomainParam.load()));
+    topology = juce::jlimit(0, 1, juce::roundToInt(topologyParam.load()));
+
+    // Output ceiling stage
+    limiterEnabled = limiterParam.load() >= 0.5f;
+    ceilingLinear = decibelTable->decibelsToGain(ceilingParam.load());
+
+    bypass = bypassParam.load() >= 0.5f;
     
-    // Convert makeup from dB to linear gain
-    float makeupDb = makeupParam.load();
-    makeupLinear = juce::Decibels::decibelsToGain(makeupDb);
+    // Auto makeup: half the reduction the curve applies to a 0 dBFS level, so
+    // loud passages stay near their level and quiet ones come up. Only
+    // recomputed when the curve changes; the knob then acts as a trim.
+    autoMakeup = autoMakeupParam.load() >= 0.5f;
+
+    if (! autoMakeup)
+    {
+        // Forget the cached curve, so switching back on recomputes the makeup
+        autoMakeupDb = 0.0f;
+        autoMakeupThreshold = std::numeric_limits<float>::quiet_NaN();
+        autoMakeupRatio = std::numeric_limits<float>::quiet_NaN();
+        autoMakeupKnee = std::numeric_limits<float>::quiet_NaN();
+    }
+    else if (threshold != autoMakeupThreshold || ratio != autoMakeupRatio || knee != autoMakeupKnee)
+    {
+        autoMakeupThreshold = threshold;
+        autoMakeupRatio = ratio;
+        autoMakeupKnee = knee;
+
+        const auto curve = StaticCurve::create(threshold, ratio, knee, expanderThreshold, 1.0f, 1.0f);
+        autoMakeupDb = 0.5f * curve.getCompressionDb(0.0f);
+    }
+
+    // Convert makeup from dB to linear gain (the compressor smooths it as usual)
+    float makeupDb = makeupParam.load() + autoMakeupDb;
+    makeupLinear = decibelTable->decibelsToGain(makeupDb);
     
     // Calculate attack and release coefficients
     float attackMs = attackParam.load();
-    float releaseMs = releaseParam.load();
+    releaseMs = releaseParam.load();
+    autoRelease = autoReleaseParam.load() >= 0.5f;
     
     attackCoeff = calculateCoefficient(static_cast<double>(attackMs));
     releaseCoeff = calculateCoefficient(static_cast<double>(releaseMs));
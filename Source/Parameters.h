@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "SharedTables.h"
+#include "StateFormat.h"
+#include "StaticCurve.h"
 
 /**
  * Parameters class for FIDI Comp
@@ -17,9 +20,16 @@ public:
     /** Set the sample rate for coefficient calculations */
     void setSampleRate(double newSampleRate) noexcept;
 
-    /** Update all DSP coefficients from current parameter values */
+    /**
+     * Update all DSP coefficients from current parameter values. Returns early
+     * when no raw value changed since the last call, so it is cheap enough for
+     * every host block however small.
+     */
     void update() noexcept;
 
+    /** One-pole coefficient for a time in milliseconds (table lookup, safe on the audio thread) */
+    [[nodiscard]] double calculateCoefficient(double timeMs) const noexcept;
+
     //==============================================================================
     // DSP-ready values (updated by update())
     
@@ -27,28 +37,84 @@ public:
     float ratio = 4.0f;             // :1
     float knee = 6.0f;              // dB
     float mix = 1.0f;               // 0.0 to 1.0
-    float makeupLinear = 1.0f;      // Linear gain
+    float makeupLinear = 1.0f;      // Linear gain (manual makeup plus auto makeup)
+    bool autoMakeup = false;        // Derive makeup from the static curve
+    float autoMakeupDb = 0.0f;      // Current auto makeup (0 when off)
+    float expanderThreshold = -60.0f; // dB
+    float expanderRatio = 1.0f;     // 1:N downward expansion (1 = off)
+    float upwardRatio = 1.0f;       // N:1 upward compression (1 = off)
+    float link = 1.0f;              // Stereo link, 0.0 (independent) to 1.0 (fully linked)
+    bool midSide = false;           // Detect and compress mid/side instead of left/right
+    int linkGroup = 0;              // Shared detector group (0 = none)
+    int quality = 1;                // 0 = eco, 1 = standard, 2 = high
+    bool offlineHighQuality = true; // High quality while the host renders offline
+    int detector = 0;               // 0 = branching, 1 = decoupled, 2 = smooth peak
+    int detectorDomain = 0;         // 0 = linear, 1 = log
+    int topology = 0;               // 0 = feed-forward, 1 = feedback
+    bool limiterEnabled = false;    // Output ceiling stage on/off
+    float ceilingLinear = 1.0f;     // Output ceiling as linear gain
+    bool bypass = false;            // Plugin-owned bypass (crossfaded)
     
     double attackCoeff = 0.0;       // One-pole attack coefficient
     double releaseCoeff = 0.0;      // One-pole release coefficient
+    float releaseMs = 100.0f;       // Release time (base for auto release)
+    bool autoRelease = false;       // Program-dependent release
     double smoothingCoeff = 0.0;    // Parameter smoothing coefficient
 
 private:
-    //==============================================================================
-    /** Calculate one-pole filter coefficient from time in milliseconds */
-    [[nodiscard]] double calculateCoefficient(double timeMs) const noexcept;
-
     //==============================================================================
     double sampleRate = 44100.0;
 
+    // Shared lookup tables (replaced in setSampleRate, never on the audio thread)
+    std::shared_ptr<const SharedTables::CoefficientTable> coefficientTable;
+    std::shared_ptr<const SharedTables::DecibelTable> decibelTable;
+
+    // Curve settings the auto makeup was last computed for
+    float autoMakeupThreshold = std::numeric_limits<float>::quiet_NaN();
+    float autoMakeupRatio = std::numeric_limits<float>::quiet_NaN();
+    float autoMakeupKnee = std::numeric_limits<float>::quiet_NaN();
+
+    /** Relaxed loads of every raw value against the previous call; records the new ones */
+    [[nodiscard]] bool rawValuesChanged() noexcept;
+
     // Raw parameter references
     std::atomic<float>& thresholdParam;
     std::atomic<float>& ratioParam;
     std::atomic<float>& attackParam;
     std::atomic<float>& releaseParam;
+    std::atomic<float>& autoReleaseParam;
     std::atomic<float>& kneeParam;
     std::atomic<float>& makeupParam;
+    std::atomic<float>& autoMakeupParam;
     std::atomic<float>& mixParam;
+    std::atomic<float>& expanderThresholdParam;
+    std::atomic<float>& expanderRatioParam;
+    std::atomic<float>& upwardRatioParam;
+    std::atomic<float>& linkParam;
+    std::atomic<float>& stereoModeParam;
+    std::atomic<float>& linkGroupParam;
+    std::atomic<float>& qualityParam;
+    std::atomic<float>& offlineHighParam;
+    std::atomic<float>& detectorParam;
+    std::atomic<float>& detectorDomainParam;
+    std::atomic<float>& topologyParam;
+    std::atomic<float>& limiterParam;
+    std::atomic<float>& ceilingParam;
+    std::atomic<float>& bypassParam;
+
+    // The references above, in order, and their values at the last update (NaN forces one).
+    // Every stored parameter plus bypass, so a parameter appended to the state format
+    // fails to compile until its reference is listed in the constructor's makeRawParams.
+    static constexpr size_t numRawParams = StateFormat::parameterOrder.size() + 1;
+    std::array<std::atomic<float>*, numRawParams> rawParams;
+    std::array<float, numRawParams> lastRawValues;
+
+    template <typename... Params>
+    [[nodiscard]] static std::array<std::atomic<float>*, numRawParams> makeRawParams(Params&... params) noexcept
+    {
+        static_assert(sizeof...(Params) == numRawParams, "rawParams must list every raw parameter reference");
+        return { &params... };
+    }
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Parameters)
@@ -1,73 +1,260 @@
 #include "PluginEditor.h"
+#include "Trace.h"
 
 //==============================================================================
 FIDICompEditor::FIDICompEditor(FIDICompProcessor& p)
     : AudioProcessorEditor(&p),
       processorRef(p),
       gainReductionMeter(p.getGainReduction()),
-      thresholdAttachment(p.getAPVTS(), "threshold", thresholdSlider),
-      ratioAttachment(p.getAPVTS(), "ratio", ratioSlider),
-      attackAttachment(p.getAPVTS(), "attack", attackSlider),
-      releaseAttachment(p.getAPVTS(), "release", releaseSlider),
-      kneeAttachment(p.getAPVTS(), "knee", kneeSlider),
-      makeupAttachment(p.getAPVTS(), "makeup", makeupSlider),
-      mixAttachment(p.getAPVTS(), "mix", mixSlider)
+      spectrumDisplay(p.getSpectrumAnalyser()),
+      statusBar(p.getInputLoudness(), p.getOutputLoudness(), p.getGainReductionStats(),
+                p.getAnalysisStats(), p.getAnalysisAvailable(), p.getSanitizerCounters()),
+      knobUpdates(*this),
+      bypassAttachment(p.getAPVTS(), "bypass", bypassButton),
+      midSideAttachment(p.getAPVTS(), "stereoMode", midSideButton),
+      limiterAttachment(p.getAPVTS(), "limiter", limiterButton),
+      autoReleaseAttachment(p.getAPVTS(), "autoRelease", autoReleaseButton),
+      autoMakeupAttachment(p.getAPVTS(), "autoMakeup", autoMakeupButton),
+      offlineHighAttachment(p.getAPVTS(), "offlineHigh", offlineHighButton)
 {
-    setLookAndFeel(&lookAndFeel);
+    setLookAndFeel(&lookAndFeel.get());
+    setOpaque(true);
+
+    addAndMakeVisible(content);
+    content.addAndMakeVisible(background);
     
     // Configure all sliders
-    setupSlider(thresholdSlider, thresholdLabel, "THRESHOLD");
-    setupSlider(ratioSlider, ratioLabel, "RATIO");
-    setupSlider(attackSlider, attackLabel, "ATTACK");
-    setupSlider(releaseSlider, releaseLabel, "RELEASE");
-    setupSlider(kneeSlider, kneeLabel, "KNEE");
-    setupSlider(makeupSlider, makeupLabel, "MAKEUP");
-    setupSlider(mixSlider, mixLabel, "MIX");
-    
-    // Configure title label
-    titleLabel.setText("FIDI COMP", juce::dontSendNotification);
-    titleLabel.setFont(juce::FontOptions(28.0f).withStyle("Bold"));
-    titleLabel.setColour(juce::Label::textColourId, juce::Colour(0xff00d4ff));
-    titleLabel.setJustificationType(juce::Justification::centredLeft);
-    addAndMakeVisible(titleLabel);
-    
-    // Configure meter label
-    meterLabel.setText("GR", juce::dontSendNotification);
-    meterLabel.setFont(juce::FontOptions(11.0f).withStyle("Bold"));
-    meterLabel.setColour(juce::Label::textColourId, juce::Colour(0x99ffffff));
-    meterLabel.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(meterLabel);
-    
-    // Add meter
-    addAndMakeVisible(gainReductionMeter);
-    
-    // Set window size - increased for better layout
-    setSize(700, 340);
+    for (auto* slider : { &thresholdSlider, &ratioSlider, &attackSlider, &releaseSlider, &kneeSlider,
+                          &makeupSlider, &mixSlider, &linkSlider, &ceilingSlider,
+                          &expanderThresholdSlider, &expanderRatioSlider, &upwardRatioSlider })
+        setupSlider(*slider);
+
+    // Knobs follow host automation once per display frame instead of once per change
+    const std::pair<juce::Slider*, const char*> knobParameters[] = {
+        { &thresholdSlider, "threshold" }, { &ratioSlider, "ratio" }, { &attackSlider, "attack" },
+        { &releaseSlider, "release" }, { &kneeSlider, "knee" }, { &makeupSlider, "makeup" },
+        { &mixSlider, "mix" }, { &linkSlider, "link" }, { &ceilingSlider, "ceiling" },
+        { &expanderThresholdSlider, "expThreshold" }, { &expanderRatioSlider, "expRatio" },
+        { &upwardRatioSlider, "upwardRatio" }
+    };
+
+    for (const auto& [slider, parameterID] : knobParameters)
+        if (auto* parameter = p.getAPVTS().getParameter(parameterID))
+            knobUpdates.attach(*parameter, *slider);
+
+    // Configure header toggles
+    setupToggle(bypassButton, "BYPASS");
+    setupToggle(midSideButton, "M/S");
+    midSideButton.setTooltip("Mid/side detection; LINK pulls the side towards the mid");
+    setupToggle(limiterButton, "LIMIT");
+    setupToggle(autoReleaseButton, "AUTO REL");
+    setupToggle(autoMakeupButton, "AUTO MU");
+
+    // Link group selector (items must exist before the attachment syncs the selection)
+    linkGroupBox.addItem("NO GROUP", 1);
+    for (int group = 1; group <= LinkGroups::numGroups; ++group)
+        linkGroupBox.addItem("GROUP " + juce::String(group), group + 1);
+
+    linkGroupBox.setTooltip("Link group");
+    linkGroupAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        p.getAPVTS(), "linkGroup", linkGroupBox);
+    content.addAndMakeVisible(linkGroupBox);
+
+    // Quality tier selector and offline render override
+    qualityBox.addItemList({ "ECO", "STANDARD", "HIGH" }, 1);
+    qualityAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        p.getAPVTS(), "quality", qualityBox);
+    content.addAndMakeVisible(qualityBox);
+
+    setupToggle(offlineHighButton, "HQ RENDER");
+    offlineHighButton.setTooltip("Use high quality while the host renders offline");
+
+    // Detector topology: detector, domain and feed-forward/feedback
+    detectorBox.addItemList({ "BRANCHING", "DECOUPLED", "SMOOTH PEAK" }, 1);
+    detectorAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        p.getAPVTS(), "detector", detectorBox);
+    content.addAndMakeVisible(detectorBox);
+
+    detectorDomainBox.addItemList({ "LINEAR", "LOG" }, 1);
+    detectorDomainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        p.getAPVTS(), "detectorDomain", detectorDomainBox);
+    content.addAndMakeVisible(detectorDomainBox);
+
+    topologyBox.addItemList({ "FEED-FORWARD", "FEEDBACK" }, 1);
+    topologyAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        p.getAPVTS(), "topology", topologyBox);
+    content.addAndMakeVisible(topologyBox);
+
+    // Learn mode: target average gain reduction, then listen to playback
+    for (int i = 0; i < static_cast<int>(std::size(learnTargetsDb)); ++i)
+        learnTargetBox.addItem(juce::String(learnTargetsDb[i], 0) + " dB GR", i + 1);
+
+    learnTargetBox.setSelectedId(3, juce::dontSendNotification);
+    learnTargetBox.setTooltip("Average gain reduction to learn the threshold for");
+    content.addAndMakeVisible(learnTargetBox);
+
+    learnButton.setButtonText("LEARN");
+    learnButton.setTooltip("Listen to a few seconds of playback, then set threshold and makeup");
+    learnButton.onClick = [this] { toggleLearning(); };
+    content.addAndMakeVisible(learnButton);
+    
+    // Add meter, with the spectrum overlay behind it
+    content.addChildComponent(spectrumDisplay);
+    content.addAndMakeVisible(gainReductionMeter);
+
+    setupToggle(spectrumButton, "SPEC");
+    spectrumButton.setTooltip("Input and output spectrum behind the meter");
+    spectrumButton.onClick = [this] { setSpectrumVisible(spectrumButton.getToggleState()); };
+    setSpectrumVisible(p.isSpectrumVisible());
+
+    // Loudness readout along the bottom
+    content.addAndMakeVisible(statusBar);
+
+    layoutContent();
+
+    // Any size with the base aspect ratio, reopened at the last one
+    const float scale = p.getEditorScale();
+
+    setResizable(true, true);
+    setResizeLimits(baseWidth / 2, baseHeight / 2, baseWidth * 2, baseHeight * 2);
+    getConstrainer()->setFixedAspectRatio(static_cast<double>(baseWidth) / static_cast<double>(baseHeight));
+
+    setSize(juce::roundToInt(static_cast<float>(baseWidth) * scale),
+            juce::roundToInt(static_cast<float>(baseHeight) * scale));
+
+    // The tooltip window is created once the mouse first enters a control
+    content.addMouseListener(this, true);
 }
 
 FIDICompEditor::~FIDICompEditor()
 {
+    // Nobody would apply the suggestion
+    processorRef.getThresholdLearner().cancel();
+    content.removeMouseListener(this);
     setLookAndFeel(nullptr);
 }
 
 //==============================================================================
-void FIDICompEditor::setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& labelText)
+FIDICompEditor::Background::Background()
+{
+    // Repainted from the cached image unless the size or display scale changes
+    setOpaque(true);
+    setBufferedToImage(true);
+    setInterceptsMouseClicks(false, false);
+}
+
+void FIDICompEditor::Background::addCaption(const juce::String& text, juce::Rectangle<int> area, const juce::Font& font)
+{
+    captions.push_back({ text, area, font });
+}
+
+//==============================================================================
+void FIDICompEditor::setupSlider(juce::Slider& slider)
 {
     slider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
     slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 65, 18);
     slider.setColour(juce::Slider::textBoxTextColourId, juce::Colours::white);
-    addAndMakeVisible(slider);
-    
-    label.setText(labelText, juce::dontSendNotification);
-    label.setFont(juce::FontOptions(10.0f).withStyle("Bold"));
-    label.setColour(juce::Label::textColourId, juce::Colour(0x99ffffff));
-    label.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(label);
+    content.addAndMakeVisible(slider);
+}
+
+void FIDICompEditor::setupToggle(juce::TextButton& button, const juce::String& buttonText)
+{
+    button.setButtonText(buttonText);
+    button.setClickingTogglesState(true);
+    content.addAndMakeVisible(button);
+}
+
+//==============================================================================
+void FIDICompEditor::setSpectrumVisible(bool shouldBeVisible)
+{
+    spectrumButton.setToggleState(shouldBeVisible, juce::dontSendNotification);
+    spectrumDisplay.setVisible(shouldBeVisible);
+    gainReductionMeter.setBackdropVisible(shouldBeVisible);
+    processorRef.setSpectrumVisible(shouldBeVisible);
+}
+
+//==============================================================================
+void FIDICompEditor::toggleLearning()
+{
+    auto& learner = processorRef.getThresholdLearner();
+
+    if (learner.isListening())
+    {
+        learner.cancel();
+        stopTimer();
+        learnButton.setButtonText("LEARN");
+        learnButton.setToggleState(false, juce::dontSendNotification);
+        return;
+    }
+
+    auto& apvts = processorRef.getAPVTS();
+    const int target = juce::jlimit(0, static_cast<int>(std::size(learnTargetsDb)) - 1,
+                                    learnTargetBox.getSelectedItemIndex());
+
+    ThresholdLearner::Settings settings;
+    settings.ratio = apvts.getRawParameterValue("ratio")->load();
+    settings.knee = apvts.getRawParameterValue("knee")->load();
+    settings.targetDb = learnTargetsDb[target];
+    learner.start(settings);
+
+    learnButton.setButtonText("LISTENING");
+    learnButton.setToggleState(true, juce::dontSendNotification);
+    startTimerHz(10);
+}
+
+void FIDICompEditor::applySuggestion(const ThresholdLearner::Suggestion& suggestion)
+{
+    auto& apvts = processorRef.getAPVTS();
+
+    auto setParameter = [&apvts](const juce::String& parameterID, float value)
+    {
+        if (auto* parameter = apvts.getParameter(parameterID))
+        {
+            parameter->beginChangeGesture();
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+            parameter->endChangeGesture();
+        }
+    };
+
+    setParameter("threshold", suggestion.thresholdDb);
+
+    // Auto makeup already level-matches the new curve
+    if (apvts.getRawParameterValue("autoMakeup")->load() < 0.5f)
+        setParameter("makeup", suggestion.makeupDb);
+}
+
+void FIDICompEditor::timerCallback()
+{
+    auto& learner = processorRef.getThresholdLearner();
+    ThresholdLearner::Suggestion suggestion;
+
+    if (learner.takeSuggestion(suggestion))
+    {
+        if (suggestion.valid)
+            applySuggestion(suggestion);
+    }
+    else if (learner.isListening())
+    {
+        return;
+    }
+
+    // Finished, or cancelled by prepareToPlay or bypass
+    stopTimer();
+    learnButton.setButtonText("LEARN");
+    learnButton.setToggleState(false, juce::dontSendNotification);
 }
 
 //==============================================================================
 void FIDICompEditor::paint(juce::Graphics& g)
 {
+    // Only visible where the aspect ratio rounds off a pixel
+    g.fillAll(juce::Colour(0xff1a1a2e));
+}
+
+void FIDICompEditor::Background::paint(juce::Graphics& g)
+{
+    FIDI_TRACE_SCOPE("FIDICompEditor::Background::paint");
+
     // Background - dark gradient
     juce::ColourGradient bgGradient(
         juce::Colour(0xff0d0d1a), 0.0f, 0.0f,
@@ -102,30 +289,65 @@ void FIDICompEditor::paint(juce::Graphics& g)
     // Subtle glow under header line
     g.setColour(juce::Colour(0x2000d4ff));
     g.fillRect(20, 56, getWidth() - 40, 4);
+
+    // Title
+    g.setColour(juce::Colour(0xff00d4ff));
+    g.setFont(style->titleFont);
+    g.drawText("FIDI COMP", 25, 14, 200, 30, juce::Justification::centredLeft);
     
     // Section labels
     g.setColour(juce::Colour(0x60ffffff));
-    g.setFont(juce::FontOptions(9.0f).withStyle("Bold"));
+    g.setFont(style->sectionFont);
     
     // Upper row label
     g.drawText("COMPRESSION", 25, 70, 100, 14, juce::Justification::centredLeft);
     
     // Lower row label
     g.drawText("OUTPUT", 25, 200, 100, 14, juce::Justification::centredLeft);
+
+    // Bottom row label
+    g.drawText("DYNAMICS", 25, 315, 100, 14, juce::Justification::centredLeft);
     
     // Version tag
     g.setColour(juce::Colour(0x40ffffff));
-    g.setFont(juce::FontOptions(10.0f));
+    g.setFont(style->smallFont);
     g.drawText("v1.0", getWidth() - 50, 20, 30, 14, juce::Justification::centredRight);
+
+    // Knob, selector and meter captions
+    g.setColour(juce::Colour(0x99ffffff));
+
+    for (const auto& caption : captions)
+    {
+        g.setFont(caption.font);
+        g.drawText(caption.text, caption.area, juce::Justification::centred);
+    }
 }
 
 //==============================================================================
 void FIDICompEditor::resized()
 {
-    auto bounds = getLocalBounds();
-    
-    // Title area
-    titleLabel.setBounds(25, 14, 200, 30);
+    // The layout stays at the base size; only its scale follows the window
+    const float scale = static_cast<float>(getWidth()) / static_cast<float>(baseWidth);
+    content.setTransform(juce::AffineTransform::scale(scale));
+    processorRef.setEditorScale(scale);
+}
+
+void FIDICompEditor::mouseEnter(const juce::MouseEvent&)
+{
+    if (tooltipWindow == nullptr)
+        tooltipWindow = std::make_unique<juce::TooltipWindow>(this);
+}
+
+void FIDICompEditor::layoutContent()
+{
+    content.setSize(baseWidth, baseHeight);
+    background.setBounds(content.getLocalBounds());
+
+    const auto& style = background.style.get();
+    auto bounds = content.getLocalBounds();
+
+    // Status bar along the bottom edge
+    statusBar.setBounds(bounds.removeFromBottom(statusBarHeight));
     
     // Meter on the right side
     int meterWidth = 35;
@@ -133,12 +355,14 @@ void FIDICompEditor::resized()
     auto meterArea = bounds.removeFromRight(meterWidth + meterMargin * 2);
     meterArea = meterArea.reduced(meterMargin, 0);
     meterArea.removeFromTop(70);
-    meterArea.removeFromBottom(25);
+    auto spectrumToggleArea = meterArea.removeFromBottom(25);
     
-    meterLabel.setBounds(meterArea.removeFromBottom(18));
+    background.addCaption("GR", meterArea.removeFromBottom(18), style.meterFont);
     gainReductionMeter.setBounds(meterArea.reduced(0, 5));
+    spectrumDisplay.setBounds(gainReductionMeter.getBounds());
+    spectrumButton.setBounds(spectrumToggleArea.withSizeKeepingCentre(meterWidth, 18));
     
-    // Knob layout - 2 rows
+    // Knob layout - 3 rows
     int knobSize = 75;
     int labelHeight = 16;
     int rowHeight = 115;
@@ -149,24 +373,77 @@ void FIDICompEditor::resized()
     int availableWidth = bounds.getWidth() - leftMargin - 20;
     int colWidth = availableWidth / 5;
     
-    // Lambda to position a slider and label
-    auto positionKnob = [&](juce::Slider& slider, juce::Label& label, int col, int row)
+    // Lambda to position a slider and its caption
+    auto positionKnob = [&](juce::Slider& slider, const juce::String& caption, int col, int row)
     {
         int x = leftMargin + col * colWidth + (colWidth - knobSize) / 2;
         int y = startY + row * rowHeight;
         
-        label.setBounds(x, y, knobSize, labelHeight);
+        background.addCaption(caption, { x, y, knobSize, labelHeight }, style.captionFont);
         slider.setBounds(x, y + labelHeight, knobSize, knobSize);
     };
     
     // Row 1: Compression controls (Threshold, Ratio, Attack, Release, Knee)
-    positionKnob(thresholdSlider, thresholdLabel, 0, 0);
-    positionKnob(ratioSlider, ratioLabel, 1, 0);
-    positionKnob(attackSlider, attackLabel, 2, 0);
-    positionKnob(releaseSlider, releaseLabel, 3, 0);
-    positionKnob(kneeSlider, kneeLabel, 4, 0);
-    
-    // Row 2: Output controls (Makeup, Mix)
-    positionKnob(makeupSlider, makeupLabel, 0, 1);
-    positionKnob(mixSlider, mixLabel, 1, 1);
+    positionKnob(thresholdSlider, "THRESHOLD", 0, 0);
+    positionKnob(ratioSlider, "RATIO", 1, 0);
+    positionKnob(attackSlider, "ATTACK", 2, 0);
+    positionKnob(releaseSlider, "RELEASE", 3, 0);
+    positionKnob(kneeSlider, "KNEE", 4, 0);
+    
+    // Row 2: Output controls (Makeup, Mix) and stereo link
+    positionKnob(makeupSlider, "MAKEUP", 0, 1);
+    positionKnob(mixSlider, "MIX", 1, 1);
+    positionKnob(linkSlider, "LINK", 2, 1);
+    positionKnob(ceilingSlider, "CEILING", 3, 1);
+
+    // Row 3: Expander / gate and upward compression segments of the curve
+    positionKnob(expanderThresholdSlider, "EXP THRESH", 0, 2);
+    positionKnob(expanderRatioSlider, "EXP RATIO", 1, 2);
+    positionKnob(upwardRatioSlider, "UPWARD", 2, 2);
+
+    // Quality selector and render override share the next column
+    {
+        int x = leftMargin + 3 * colWidth + (colWidth - knobSize) / 2 - 10;
+        int y = startY + 2 * rowHeight;
+        int width = knobSize + 20;
+
+        background.addCaption("QUALITY", { x, y, width, labelHeight }, style.captionFont);
+        qualityBox.setBounds(x, y + labelHeight + 14, width, 22);
+        offlineHighButton.setBounds(x, y + labelHeight + 44, width, 20);
+    }
+
+    // Detector topology selectors in the last column of the curve row
+    {
+        int x = leftMargin + 4 * colWidth + (colWidth - knobSize) / 2 - 10;
+        int y = startY + 2 * rowHeight;
+        int width = knobSize + 20;
+
+        background.addCaption("DETECTOR", { x, y, width, labelHeight }, style.captionFont);
+        detectorBox.setBounds(x, y + labelHeight + 6, width, 20);
+        detectorDomainBox.setBounds(x, y + labelHeight + 30, width, 20);
+        topologyBox.setBounds(x, y + labelHeight + 54, width, 20);
+    }
+
+    // Learn mode takes the free column of the output row, laid out like the quality selector
+    {
+        int x = leftMargin + 4 * colWidth + (colWidth - knobSize) / 2 - 10;
+        int y = startY + rowHeight;
+        int width = knobSize + 20;
+
+        background.addCaption("AUTO THRESH", { x, y, width, labelHeight }, style.captionFont);
+        learnTargetBox.setBounds(x, y + labelHeight + 14, width, 22);
+        learnButton.setBounds(x, y + labelHeight + 44, width, 20);
+    }
+
+    // Header toggles, right-aligned before the version tag
+    int toggleWidth = 58;
+    int toggleRight = baseWidth - 60;
+    for (auto* toggle : { &bypassButton, &limiterButton, &midSideButton, &autoMakeupButton, &autoReleaseButton })
+    {
+        toggle->setBounds(toggleRight - toggleWidth, 18, toggleWidth, 20);
+        toggleRight -= toggleWidth + 6;
+    }
+
+    int groupBoxWidth = 90;
+    linkGroupBox.setBounds(toggleRight - groupBoxWidth, 18, groupBoxWidth, 20);
 }
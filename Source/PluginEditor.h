@@ -4,13 +4,23 @@
 #include "PluginProcessor.h"
 #include "LookAndFeel.h"
 #include "Meter.h"
+#include "ParameterUpdateBatcher.h"
+#include "SpectrumDisplay.h"
+#include "StatusBar.h"
 
 /**
  * FIDI Comp Plugin Editor
  * Main GUI class with rotary knobs for all compression parameters
- * and real-time gain reduction metering.
+ * and real-time gain reduction metering, with an optional input/output
+ * spectrum behind the meter. Controls are laid out once at the base size
+ * inside a content component that is scaled to the window, so resizing only
+ * changes a transform. Knobs follow their parameters once per display frame,
+ * however dense the automation. Everything static (background, title,
+ * captions) is drawn by one buffered layer, rendered again only when the
+ * size or display scale changes.
  */
-class FIDICompEditor : public juce::AudioProcessorEditor
+class FIDICompEditor : public juce::AudioProcessorEditor,
+                       private juce::Timer
 {
 public:
     //==============================================================================
@@ -20,18 +30,76 @@ public:
     //==============================================================================
     void paint(juce::Graphics&) override;
     void resized() override;
+    void mouseEnter(const juce::MouseEvent& event) override;
+
+    static constexpr int baseWidth = 700;       // Logical size the layout is written for
+    static constexpr int baseHeight = 495;
 
 private:
+    //==============================================================================
+    /** Static text and decoration of the editor, cached as an image */
+    class Background : public juce::Component
+    {
+    public:
+        Background();
+
+        void paint(juce::Graphics& g) override;
+
+        /** Add a centred caption, set while laying out */
+        void addCaption(const juce::String& text, juce::Rectangle<int> area, const juce::Font& font);
+
+        juce::SharedResourcePointer<FIDIEditorStyle> style;
+
+    private:
+        struct Caption
+        {
+            juce::String text;
+            juce::Rectangle<int> area;
+            juce::Font font;
+        };
+
+        std::vector<Caption> captions;
+    };
+
     //==============================================================================
     /** Helper to create and configure a rotary slider */
-    void setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& labelText);
+    void setupSlider(juce::Slider& slider);
+
+    /** Helper to create and configure a header toggle button */
+    void setupToggle(juce::TextButton& button, const juce::String& buttonText);
+
+    /** Start listening with the current ratio, knee and target, or cancel */
+    void toggleLearning();
+
+    /** Set threshold (and makeup unless auto makeup is on) as host-visible gestures */
+    void applySuggestion(const ThresholdLearner::Suggestion& suggestion);
+
+    /** Show or hide the spectrum overlay and remember the choice on the processor */
+    void setSpectrumVisible(bool shouldBeVisible);
+
+    /** Polls the learner while it listens */
+    void timerCallback() override;
+
+    /** Place every control and caption at the base size (once) */
+    void layoutContent();
 
     //==============================================================================
     [[maybe_unused]] FIDICompProcessor& processorRef;
-    FIDILookAndFeel lookAndFeel;
+    juce::SharedResourcePointer<FIDILookAndFeel> lookAndFeel;   // One per process
+
+    // Scaled to the window; parent of every control
+    juce::Component content;
+    Background background;
     
     // Meter
     Meter gainReductionMeter;
+    SpectrumDisplay spectrumDisplay;    // Behind the meter, analysing only while visible
+    juce::TextButton spectrumButton;
+    StatusBar statusBar;
+    static constexpr int statusBarHeight = 40;
+
+    // Shows the tooltips of the link group selector and the status bar; created on first hover
+    std::unique_ptr<juce::TooltipWindow> tooltipWindow;
     
     // Sliders
     juce::Slider thresholdSlider;
@@ -41,26 +109,47 @@ private:
     juce::Slider kneeSlider;
     juce::Slider makeupSlider;
     juce::Slider mixSlider;
-    
-    // Labels
-    juce::Label thresholdLabel;
-    juce::Label ratioLabel;
-    juce::Label attackLabel;
-    juce::Label releaseLabel;
-    juce::Label kneeLabel;
-    juce::Label makeupLabel;
-    juce::Label mixLabel;
-    juce::Label titleLabel;
-    juce::Label meterLabel;
+    juce::Slider linkSlider;
+    juce::Slider ceilingSlider;
+    juce::Slider expanderThresholdSlider;
+    juce::Slider expanderRatioSlider;
+    juce::Slider upwardRatioSlider;
+
+    // Header toggles
+    juce::TextButton bypassButton;
+    juce::TextButton midSideButton;
+    juce::TextButton limiterButton;
+    juce::TextButton autoReleaseButton;
+    juce::TextButton autoMakeupButton;
+    juce::ComboBox linkGroupBox;
+
+    // Quality tier
+    juce::ComboBox qualityBox;
+    juce::TextButton offlineHighButton;
+
+    // Detector topology
+    juce::ComboBox detectorBox;
+    juce::ComboBox detectorDomainBox;
+    juce::ComboBox topologyBox;
+
+    // Auto-threshold learn mode
+    juce::ComboBox learnTargetBox;
+    juce::TextButton learnButton;
+    static constexpr float learnTargetsDb[] = { 1.0f, 2.0f, 3.0f, 6.0f };
     
     // Attachments (must be declared after sliders)
-    juce::AudioProcessorValueTreeState::SliderAttachment thresholdAttachment;
-    juce::AudioProcessorValueTreeState::SliderAttachment ratioAttachment;
-    juce::AudioProcessorValueTreeState::SliderAttachment attackAttachment;
-    juce::AudioProcessorValueTreeState::SliderAttachment releaseAttachment;
-    juce::AudioProcessorValueTreeState::SliderAttachment kneeAttachment;
-    juce::AudioProcessorValueTreeState::SliderAttachment makeupAttachment;
-    juce::AudioProcessorValueTreeState::SliderAttachment mixAttachment;
+    ParameterUpdateBatcher knobUpdates;     // Every knob, updated once per frame
+    juce::AudioProcessorValueTreeState::ButtonAttachment bypassAttachment;
+    juce::AudioProcessorValueTreeState::ButtonAttachment midSideAttachment;
+    juce::AudioProcessorValueTreeState::ButtonAttachment limiterAttachment;
+    juce::AudioProcessorValueTreeState::ButtonAttachment autoReleaseAttachment;
+    juce::AudioProcessorValueTreeState::ButtonAttachment autoMakeupAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> linkGroupAttachment;  // Created once the items exist
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> qualityAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> detectorAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> detectorDomainAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> topologyAttachment;
+    juce::AudioProcessorValueTreeState::ButtonAttachment offlineHighAttachment;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FIDICompEditor)
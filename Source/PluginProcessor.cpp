@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "OfflineRenderer.h"
 
 //==============================================================================
 const juce::Identifier FIDICompProcessor::stateIdentifier{"FIDICompState"};
@@ -13,6 +14,7 @@ FIDICompProcessor::FIDICompProcessor()
       parameters(apvts),
       compressor(parameters)
 {
+    bypassParameter = apvts.getParameter("bypass");
 }
 
 FIDICompProcessor::~FIDICompProcessor()
@@ -80,6 +82,120 @@ juce::AudioProcessorValueTreeState::ParameterLayout FIDICompProcessor::createPar
         100.0f,
         juce::AudioParameterFloatAttributes().withLabel("%")));
 
+    // Stereo link: 0 to 100% (0 = independent channels, 100 = fully linked)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"link", 1},
+        "Stereo Link",
+        juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f),
+        100.0f,
+        juce::AudioParameterFloatAttributes().withLabel("%")));
+
+    // Stereo mode: compress left/right or mid/side
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"stereoMode", 1},
+        "Stereo Mode",
+        juce::StringArray{"L/R", "M/S"},
+        0));
+
+    // Link group: instances in the same group share one detector
+    juce::StringArray linkGroupNames { "Off" };
+    for (int group = 1; group <= LinkGroups::numGroups; ++group)
+        linkGroupNames.add(juce::String(group));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"linkGroup", 1},
+        "Link Group",
+        linkGroupNames,
+        0));
+
+    // Program-dependent release on/off
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"autoRelease", 1},
+        "Auto Release",
+        false));
+
+    // Makeup derived from threshold/ratio/knee on/off
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"autoMakeup", 1},
+        "Auto Makeup",
+        false));
+
+    // Quality tier: kernel variants for the gain computer and detector
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"quality", 1},
+        "Quality",
+        juce::StringArray{"Eco", "Standard", "High"},
+        1));
+
+    // Use the high tier whenever the host renders offline
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"offlineHigh", 1},
+        "High Quality Render",
+        true));
+
+    // Detector topology: compile-time kernel variants, chosen per block
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"detector", 1},
+        "Detector",
+        juce::StringArray{"Branching", "Decoupled", "Smooth Peak"},
+        0));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"detectorDomain", 1},
+        "Detector Domain",
+        juce::StringArray{"Linear", "Log"},
+        0));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"topology", 1},
+        "Topology",
+        juce::StringArray{"Feed-Forward", "Feedback"},
+        0));
+
+    // Output ceiling limiter on/off
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"limiter", 1},
+        "Limiter",
+        false));
+
+    // Plugin-owned bypass, exposed to hosts through getBypassParameter()
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"bypass", 1},
+        "Bypass",
+        false));
+
+    // Ceiling: -24 to 0 dB
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"ceiling", 1},
+        "Ceiling",
+        juce::NormalisableRange<float>(-24.0f, 0.0f, 0.1f),
+        -0.3f,
+        juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+    // Expander threshold: -80 to 0 dB
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"expThreshold", 1},
+        "Expander Threshold",
+        juce::NormalisableRange<float>(-80.0f, 0.0f, 0.1f),
+        -60.0f,
+        juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+    // Expander ratio: 1:1 (off) to 1:20 (gate), skewed towards gentle expansion
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"expRatio", 1},
+        "Expander Ratio",
+        juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f, 0.5f),
+        1.0f,
+        juce::AudioParameterFloatAttributes().withLabel("1:")));
+
+    // Upward compression ratio: 1:1 (off) to 4:1
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"upwardRatio", 1},
+        "Upward Ratio",
+        juce::NormalisableRange<float>(1.0f, 4.0f, 0.01f, 0.5f),
+        1.0f,
+        juce::AudioParameterFloatAttributes().withLabel(":1")));
+
     return { params.begin(), params.end() };
 }
 
@@ -111,37 +227,75 @@ double FIDICompProcessor::getTailLengthSeconds() const
 
 int FIDICompProcessor::getNumPrograms()
 {
-    return 1;
+    return juce::jmax(1, presetBank->getNumPresets());
 }
 
 int FIDICompProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void FIDICompProcessor::setCurrentProgram(int index)
 {
-    juce::ignoreUnused(index);
+    StateFormat::Values values;
+    if (!presetBank->getPresetValues(index, values))
+        return;
+
+    currentProgram = index;
+
+    // Parameters jump to the preset values for host/GUI; the audio thread morphs towards them
+    StateFormat::apply(apvts, values, false);
+    presetMorphPending.store(true);
 }
 
 const juce::String FIDICompProcessor::getProgramName(int index)
 {
-    juce::ignoreUnused(index);
-    return {};
+    return presetBank->getPresetName(index);
 }
 
 void FIDICompProcessor::changeProgramName(int index, const juce::String& newName)
 {
-    juce::ignoreUnused(index, newName);
+    presetBank->renamePreset(index, newName);
+}
+
+int FIDICompProcessor::saveUserPreset(const juce::String& name)
+{
+    StateFormat::Values values;
+    StateFormat::capture(apvts, values);
+
+    const int index = presetBank->saveUserPreset(name, values);
+    if (index >= 0)
+        currentProgram = index;
+
+    return index;
 }
 
 //==============================================================================
 void FIDICompProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    juce::ignoreUnused(samplesPerBlock);
-    
+    numInputChannels = getTotalNumInputChannels();
+    numOutputChannels = getTotalNumOutputChannels();
+    groupPeak = 0.0f;
+    groupExchangeSamples = 0;
+    linkGroupMember.prepare(sampleRate, samplesPerBlock);
+
     parameters.setSampleRate(sampleRate);
     compressor.reset();
+
+    // The lookahead delay is always in the path, so latency does not depend on the ceiling switch
+    limiter.prepare(sampleRate, getTotalNumOutputChannels());
+    setLatencySamples(limiter.getLatencySamples());
+
+    bypass.prepare(sampleRate, getTotalNumOutputChannels(), samplesPerBlock);
+    bypass.reset(parameters.bypass);
+
+    inputLoudness.prepare(sampleRate);
+    outputLoudness.prepare(sampleRate);
+    thresholdLearner.prepare(sampleRate);
+    spectrumAnalyser.prepare(sampleRate);
+    telemetry.prepare(sampleRate, samplesPerBlock);
+
+    presetMorphSamples = juce::roundToInt(sampleRate * presetMorphSeconds);
     gainReductionAtomic.store(1.0f);
 }
 
@@ -169,88 +323,355 @@ bool FIDICompProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 
 void FIDICompProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    FIDI_TRACE_SCOPE("FIDICompProcessor::processBlock");
+    juce::ignoreUnused(midiMessages);
+
+    const auto startTicks = telemetry.isEnabled() ? juce::Time::getHighResolutionTicks() : 0;
+    process(buffer, false);
+
+    if (telemetry.isEnabled())
+        telemetry.addBlock(buffer.getNumSamples(), juce::Time::getHighResolutionTicks() - startTicks);
+}
+
+void FIDICompProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    FIDI_TRACE_SCOPE("FIDICompProcessor::processBlockBypassed");
     juce::ignoreUnused(midiMessages);
-    juce::ScopedNoDenormals noDenormals;
+
+    const auto startTicks = telemetry.isEnabled() ? juce::Time::getHighResolutionTicks() : 0;
+    process(buffer, true);
+
+    if (telemetry.isEnabled())
+        telemetry.addBlock(buffer.getNumSamples(), juce::Time::getHighResolutionTicks() - startTicks);
+}
+
+void FIDICompProcessor::process(juce::AudioBuffer<float>& buffer, bool hostBypassed)
+{
+    // Most hosts already flush denormals; reading the FP status is cheaper than setting and restoring it
+    std::optional<juce::ScopedNoDenormals> noDenormals;
+
+    if (! juce::FloatVectorOperations::areDenormalsDisabled())
+        noDenormals.emplace();
 
     const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
 
-    // Clear any output channels beyond input
-    for (int ch = getTotalNumInputChannels(); ch < getTotalNumOutputChannels(); ++ch)
+    // Clear any output channels beyond input (never with the supported layouts, which match)
+    for (int ch = numInputChannels; ch < numOutputChannels; ++ch)
         buffer.clear(ch, 0, numSamples);
 
+    // Check for a preset change before reading parameters so the morph targets are complete
+    const bool startPresetMorph = presetMorphPending.exchange(false);
+
     // Update parameters from APVTS
     parameters.update();
 
+    if (startPresetMorph)
+        compressor.startMorph(presetMorphSamples);
+
     // Track minimum gain reduction for metering
     float minGainReduction = 1.0f;
 
     if (numChannels == 0 || numSamples == 0)
         return;
 
+    // One vectorised pass each for input and output, only while exporting telemetry
+    const float inputPeak = telemetry.isEnabled() ? buffer.getMagnitude(0, numSamples) : 0.0f;
+
+   #if FIDI_SANITIZE_INPUT
+    // Non-finite input would poison the detector: one scan, repair only when needed
+    if ((BlockSanitizer::scan(buffer.getArrayOfReadPointers(), numChannels, numSamples) & BlockSanitizer::nonFinite) != 0)
+    {
+        BlockSanitizer::repair(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+        BlockSanitizer::increment(sanitizerCounters.nonFiniteInputBlocks);
+    }
+   #endif
+
     // Get write pointers
     float* leftChannel = buffer.getWritePointer(0);
     float* rightChannel = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
+    const int numActiveLanes = rightChannel != nullptr ? 2 : 1;
+
+    // Fully bypassed: only the lookahead delay runs (keeps the latency) plus a
+    // decimated detector update. Meters pause and link group members see this
+    // instance go stale.
+    bypass.setBypassed(parameters.bypass || hostBypassed);
+
+    if (bypass.isFullyBypassed())
+    {
+        FIDI_TRACE_SCOPE("FIDICompProcessor::bypassed");
+
+        compressor.updateWhileBypassed(buffer.getArrayOfReadPointers(), numSamples, numActiveLanes);
+        thresholdLearner.cancelWhileBypassed();
+
+        // Only the delay: no release of the gain the ceiling held before bypass
+        limiter.resetGain();
+        limiter.process(buffer.getArrayOfWritePointers(), numChannels, numSamples, false, parameters.ceilingLinear);
+
+        if (telemetry.isEnabled())
+            telemetry.addLevels(inputPeak, buffer.getMagnitude(0, numSamples), 1.0f);
+
+        return;
+    }
+
+    const bool fading = bypass.isFading();
+
+    if (fading)
+        bypass.captureDry(buffer);
+
+    // Loudness metering only K-weights here; gating runs on the analysis thread
+    inputLoudness.process(buffer.getArrayOfReadPointers(), std::min(numChannels, LoudnessMeter::maxChannels), numSamples);
+    spectrumAnalyser.push(SpectrumAnalyser::input, buffer.getArrayOfReadPointers(), numChannels, numSamples);
+
+    // M/S only applies to stereo; mono runs a single detector lane
+    const bool midSide = parameters.midSide && rightChannel != nullptr;
+
+    // Quality tier; bounces switch to high automatically when enabled
+    const auto quality = parameters.offlineHighQuality && isNonRealtime()
+                             ? Compressor::Quality::high
+                             : static_cast<Compressor::Quality>(parameters.quality);
+    compressor.setQuality(quality);
+    compressor.setMidSide(midSide);
+    compressor.setTopology(static_cast<Compressor::Detector>(parameters.detector),
+                           static_cast<Compressor::DetectorDomain>(parameters.detectorDomain),
+                           static_cast<Compressor::Topology>(parameters.topology));
+
+    // Link group: the loudest level the other members published is a floor for our detector
+    // Tiny host blocks share one group read and one publish per sub-block length
+    linkGroupMember.setGroup(parameters.linkGroup);
+
+    if (groupExchangeSamples == 0)
+        groupLevel = linkGroupMember.getGroupLevel();
+
+    float ownPeak = 0.0f;
+
+    Compressor::LaneBuffer levels;
+    Compressor::LaneBuffer gains;
+
+    FIDI_TRACE_SCOPE("FIDICompProcessor::sampleLoop");
+    FIDI_TRACE_SCOPE(compressor.getKernelName());   // Per-topology cost of the same loop
+
+    for (int start = 0; start < numSamples;)
+    {
+        const int subBlockSize = compressor.getNextSubBlockSize(numSamples - start);
+        float* left = leftChannel + start;
+        float* right = rightChannel != nullptr ? rightChannel + start : nullptr;
+
+        // Encode to mid/side in place: the lanes then carry M and S
+        if (midSide)
+        {
+            for (int i = 0; i < subBlockSize; ++i)
+            {
+                const float mid = (left[i] + right[i]) * 0.5f;
+                const float side = (left[i] - right[i]) * 0.5f;
+                left[i] = mid;
+                right[i] = side;
+            }
+        }
+
+        // Detector input per lane (high quality adds inter-sample peaks)
+        if (quality == Compressor::Quality::high)
+        {
+            const float* lanes[Compressor::numLanes] = { left, right };
+            compressor.fillOversampledLevels(lanes, levels, subBlockSize, numActiveLanes);
+        }
+        else
+        {
+            for (int i = 0; i < subBlockSize; ++i)
+                levels.samples[0][i] = std::abs(left[i]);
+
+            if (right != nullptr)
+                for (int i = 0; i < subBlockSize; ++i)
+                    levels.samples[1][i] = std::abs(right[i]);
+        }
+
+        // Own peak is tracked before the link group floor, the learner's linked level after it
+        float linkedPeak = groupLevel;
+
+        for (int lane = 0; lane < numActiveLanes; ++lane)
+        {
+            for (int i = 0; i < subBlockSize; ++i)
+            {
+                ownPeak = std::max(ownPeak, levels.samples[lane][i]);
+                levels.samples[lane][i] = std::max(levels.samples[lane][i], groupLevel);
+                linkedPeak = std::max(linkedPeak, levels.samples[lane][i]);
+            }
+        }
+
+        thresholdLearner.push(linkedPeak, subBlockSize);
+
+        // Gains include parallel mix and makeup: out = in * makeup * (dry + wet * GR)
+        const float subBlockMinGain = compressor.processSubBlock(levels, gains, subBlockSize, numActiveLanes);
+        minGainReduction = std::min(minGainReduction, subBlockMinGain);
+        gainReductionStats.add(subBlockMinGain, subBlockSize);
+
+        for (int i = 0; i < subBlockSize; ++i)
+        {
+            float outputL = left[i] * gains.samples[0][i];
+            float outputR = right != nullptr ? right[i] * gains.samples[1][i] : 0.0f;
+
+            // Decode mid/side back to left/right
+            if (midSide)
+            {
+                const float mid = outputL;
+                outputL = mid + outputR;
+                outputR = mid - outputR;
+            }
+
+            // Write output
+            left[i] = outputL;
+            if (right != nullptr)
+                right[i] = outputR;
+        }
+
+        start += subBlockSize;
+    }
+
+    groupPeak = std::max(groupPeak, ownPeak);
+    groupExchangeSamples += numSamples;
+
+    if (groupExchangeSamples >= Compressor::maxSubBlockSize)
+    {
+        linkGroupMember.publish(groupPeak);
+        groupPeak = 0.0f;
+        groupExchangeSamples = 0;
+    }
+
+    // Safety: one scan of the output instead of per-sample NaN/Inf checks
+    if (const int problems = BlockSanitizer::scan(buffer.getArrayOfReadPointers(), numChannels, numSamples);
+        problems != BlockSanitizer::clean)
+    {
+        BlockSanitizer::repair(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+
+        if ((problems & BlockSanitizer::nonFinite) != 0)
+        {
+            BlockSanitizer::increment(sanitizerCounters.nonFiniteOutputBlocks);
+
+            if (compressor.isPoisoned())
+            {
+                compressor.reset();
+                BlockSanitizer::increment(sanitizerCounters.detectorResets);
+            }
+        }
+
+        if ((problems & BlockSanitizer::denormal) != 0)
+            BlockSanitizer::increment(sanitizerCounters.denormalOutputBlocks);
+    }
+
+    // Bypass crossfade ahead of the delay, so the dry copy comes out latency aligned
+    if (fading)
+        bypass.mixDry(buffer);
+
+    // Output ceiling (also provides the constant lookahead delay). It keeps holding
+    // the processed signal down through the fade-out and is released only once
+    // fully bypassed.
+    limiter.process(buffer.getArrayOfWritePointers(), numChannels, numSamples,
+                    parameters.limiterEnabled, parameters.ceilingLinear);
+
+    outputLoudness.process(buffer.getArrayOfReadPointers(), std::min(numChannels, LoudnessMeter::maxChannels), numSamples);
+    spectrumAnalyser.push(SpectrumAnalyser::output, buffer.getArrayOfReadPointers(), numChannels, numSamples);
+
+    if (telemetry.isEnabled())
+        telemetry.addLevels(inputPeak, buffer.getMagnitude(0, numSamples), minGainReduction);
 
-    for (int sample = 0; sample < numSamples; ++sample)
+    // Update atomic for metering, keeping the minimum. The audio thread is the only
+    // writer besides the meter's reset, so a plain store suffices: a reset landing
+    // between the load and the store only drops this block's value from one frame.
+    if (minGainReduction < gainReductionAtomic.load(std::memory_order_relaxed))
+        gainReductionAtomic.store(minGainReduction, std::memory_order_relaxed);
+}
+
+void FIDICompProcessor::analyseBlock(const float* const* channels, int numChannels, int numSamples,
+                                     GainReductionStats& stats)
+{
+    FIDI_TRACE_SCOPE("FIDICompProcessor::analyseBlock");
+
+    parameters.update();
+
+    if (numChannels == 0 || numSamples == 0)
+        return;
+
+    const float* leftChannel = channels[0];
+    const float* rightChannel = numChannels > 1 ? channels[1] : nullptr;
+    const bool midSide = parameters.midSide && rightChannel != nullptr;
+    const int numActiveLanes = rightChannel != nullptr ? 2 : 1;
+
+   #if FIDI_SANITIZE_INPUT
+    // Same input scan as process(); the input is read-only here, so the detector levels get repaired instead
+    const bool repairLevels = (BlockSanitizer::scan(channels, juce::jmin(numChannels, 2), numSamples) & BlockSanitizer::nonFinite) != 0;
+
+    if (repairLevels)
+        BlockSanitizer::increment(sanitizerCounters.nonFiniteInputBlocks);
+   #else
+    constexpr bool repairLevels = false;
+   #endif
+
+    // Control-rate gain computer: statistics are per sub-block anyway
+    compressor.setQuality(Compressor::Quality::eco);
+    compressor.setMidSide(midSide);
+    compressor.setTopology(static_cast<Compressor::Detector>(parameters.detector),
+                           static_cast<Compressor::DetectorDomain>(parameters.detectorDomain),
+                           static_cast<Compressor::Topology>(parameters.topology));
+
+    Compressor::LaneBuffer levels;
+
+    for (int start = 0; start < numSamples;)
     {
-        // Read input samples
-        float inputL = leftChannel[sample];
-        float inputR = rightChannel != nullptr ? rightChannel[sample] : inputL;
-
-        // Store dry signal for parallel compression
-        float dryL = inputL;
-        float dryR = inputR;
-
-        // Stereo-linked detection: use maximum of both channels
-        float linkedLevel = std::max(std::abs(inputL), std::abs(inputR));
-
-        // Compute gain reduction (both channels get same GR for stereo linking)
-        // This also updates smoothed mix and makeup values
-        float gainReduction = compressor.computeGainReduction(linkedLevel);
-
-        // Get per-sample smoothed values (prevents zipper noise)
-        float mixAmount = compressor.getSmoothedMix();
-        float dryAmount = 1.0f - mixAmount;
-        float makeupGain = compressor.getSmoothedMakeup();
-
-        // Track minimum for metering
-        if (gainReduction < minGainReduction)
-            minGainReduction = gainReduction;
-
-        // Apply gain reduction (wet signal)
-        float wetL = inputL * gainReduction;
-        float wetR = inputR * gainReduction;
-
-        // Parallel mix
-        float outputL = dryL * dryAmount + wetL * mixAmount;
-        float outputR = dryR * dryAmount + wetR * mixAmount;
-
-        // Apply makeup gain
-        outputL *= makeupGain;
-        outputR *= makeupGain;
-
-        // Safety: prevent NaN/Inf in output (can occur with extreme settings)
-        if (std::isnan(outputL) || std::isinf(outputL))
-            outputL = 0.0f;
-        if (std::isnan(outputR) || std::isinf(outputR))
-            outputR = 0.0f;
-
-        // Write output
-        leftChannel[sample] = outputL;
-        if (rightChannel != nullptr)
-            rightChannel[sample] = outputR;
+        const int subBlockSize = compressor.getNextSubBlockSize(numSamples - start);
+        const float* left = leftChannel + start;
+        const float* right = rightChannel != nullptr ? rightChannel + start : nullptr;
+
+        if (midSide)
+        {
+            for (int i = 0; i < subBlockSize; ++i)
+            {
+                levels.samples[0][i] = std::abs((left[i] + right[i]) * 0.5f);
+                levels.samples[1][i] = std::abs((left[i] - right[i]) * 0.5f);
+            }
+        }
+        else
+        {
+            for (int i = 0; i < subBlockSize; ++i)
+                levels.samples[0][i] = std::abs(left[i]);
+
+            if (right != nullptr)
+                for (int i = 0; i < subBlockSize; ++i)
+                    levels.samples[1][i] = std::abs(right[i]);
+        }
+
+        if (repairLevels)
+        {
+            float* lanes[Compressor::numLanes] = { levels.samples[0], levels.samples[1] };
+            BlockSanitizer::repair(lanes, numActiveLanes, subBlockSize);
+        }
+
+        stats.add(compressor.analyseSubBlock(levels, subBlockSize, numActiveLanes), subBlockSize);
+        start += subBlockSize;
     }
 
-    // Update atomic for metering (compare-exchange to keep minimum)
-    float expected = gainReductionAtomic.load();
-    while (minGainReduction < expected)
+    // Same recovery as process(): a poisoned detector starts again from silence
+    if (compressor.isPoisoned())
     {
-        if (gainReductionAtomic.compare_exchange_weak(expected, minGainReduction))
-            break;
+        compressor.reset();
+        BlockSanitizer::increment(sanitizerCounters.detectorResets);
     }
 }
 
+bool FIDICompProcessor::analyse(const juce::AudioBuffer<float>& input, double sampleRate)
+{
+    FIDI_TRACE_SCOPE("FIDICompProcessor::analyse");
+
+    analysisAvailable.store(false);
+    analysisStats.reset();
+
+    juce::MemoryBlock state;
+    getStateInformation(state);
+
+    const bool analysed = OfflineRenderer::analyse(state, input, sampleRate, analysisStats);
+    analysisAvailable.store(analysed);
+    return analysed;
+}
+
 //==============================================================================
 bool FIDICompProcessor::hasEditor() const
 {
@@ -259,20 +680,35 @@ bool FIDICompProcessor::hasEditor() const
 
 juce::AudioProcessorEditor* FIDICompProcessor::createEditor()
 {
+    FIDI_TRACE_SCOPE("FIDICompProcessor::createEditor");
+
+    // Not in the constructor, so instances that never show an editor load no fonts
+    if (editorLookAndFeel == nullptr)
+    {
+        editorStyle = std::make_unique<juce::SharedResourcePointer<FIDIEditorStyle>>();
+        editorLookAndFeel = std::make_unique<juce::SharedResourcePointer<FIDILookAndFeel>>();
+    }
+
     return new FIDICompEditor(*this);
 }
 
 //==============================================================================
 void FIDICompProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    if (xml != nullptr)
-        copyXmlToBinary(*xml, destData);
+    FIDI_TRACE_SCOPE("FIDICompProcessor::getStateInformation");
+
+    // Fixed-layout binary state: no ValueTree copy or XML round trip
+    StateFormat::write(apvts, destData);
 }
 
 void FIDICompProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    FIDI_TRACE_SCOPE("FIDICompProcessor::setStateInformation");
+
+    if (StateFormat::read(apvts, data, sizeInBytes))
+        return;
+
+    // Fallback: XML state written by earlier versions
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
         apvts.replaceState(juce::ValueTree::fromXml(*xml));
@@ -1,8 +1,20 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BlockSanitizer.h"
+#include "Bypass.h"
 #include "Compressor.h"
+#include "GainReductionStats.h"
+#include "Limiter.h"
+#include "LookAndFeel.h"
+#include "LinkGroups.h"
+#include "LoudnessMeter.h"
 #include "Parameters.h"
+#include "PresetBank.h"
+#include "SpectrumAnalyser.h"
+#include "Telemetry.h"
+#include "ThresholdLearner.h"
+#include "Trace.h"
 
 //==============================================================================
 /**
@@ -25,6 +37,12 @@ public:
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
+    /** Host bypass without a bypass parameter: same crossfaded path as the plugin's own */
+    void processBlockBypassed(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    /** Lets hosts drive the plugin-owned bypass instead of cutting processing off */
+    juce::AudioProcessorParameter* getBypassParameter() const override { return bypassParameter; }
+
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -55,22 +73,131 @@ public:
     /** Returns atomic gain reduction value for metering (0.0 to 1.0, where 1.0 = no reduction) */
     [[nodiscard]] std::atomic<float>& getGainReduction() noexcept { return gainReductionAtomic; }
 
+    /** Loudness of the input (before compression) and the output (after the ceiling) */
+    [[nodiscard]] LoudnessMeter& getInputLoudness() noexcept { return inputLoudness; }
+    [[nodiscard]] LoudnessMeter& getOutputLoudness() noexcept { return outputLoudness; }
+
+    /** Gain reduction statistics since load or the last reset (audio thread writes, editor reads) */
+    [[nodiscard]] GainReductionStats& getGainReductionStats() noexcept { return gainReductionStats; }
+
+    /** Input/output spectrum for the editor's overlay, idle unless the editor shows it */
+    [[nodiscard]] SpectrumAnalyser& getSpectrumAnalyser() noexcept { return spectrumAnalyser; }
+
+    /** Learn mode: proposes a threshold and makeup from a few seconds of playback */
+    [[nodiscard]] ThresholdLearner& getThresholdLearner() noexcept { return thresholdLearner; }
+
+    /**
+     * Analysis only: run the detectors and the Eco gain computer over a block
+     * without applying gain, writing audio, metering or limiting. The Eco curve
+     * runs once per control period with no per-sample gains; non-finite input
+     * and a poisoned detector are handled as in processBlock. Not for use
+     * while the processor is playing.
+     */
+    void analyseBlock(const float* const* channels, int numChannels, int numSamples, GainReductionStats& stats);
+
+    /**
+     * Analyse a buffer with the current settings (OfflineRenderer::analyse on a
+     * fresh instance) into the analysis statistics, which the editor shows in
+     * place of the live ones once this returns true. Call from a background
+     * thread, one analysis at a time; never from the audio thread.
+     */
+    bool analyse(const juce::AudioBuffer<float>& input, double sampleRate);
+
+    /** Statistics of the last analyse() (its thread writes, editor reads) */
+    [[nodiscard]] GainReductionStats& getAnalysisStats() noexcept { return analysisStats; }
+
+    /** True once analyse() has finished; the editor clears it to go back to the live statistics */
+    [[nodiscard]] std::atomic<bool>& getAnalysisAvailable() noexcept { return analysisAvailable; }
+
+    /** Non-finite/denormal block counters for diagnostics */
+    [[nodiscard]] const BlockSanitizer::Counters& getSanitizerCounters() const noexcept { return sanitizerCounters; }
+
+    /** Last editor size relative to the base layout (message thread, not part of the state) */
+    [[nodiscard]] float getEditorScale() const noexcept { return editorScale; }
+    void setEditorScale(float newScale) noexcept { editorScale = newScale; }
+
+    /** Whether the editor shows the spectrum overlay (message thread, not part of the state) */
+    [[nodiscard]] bool isSpectrumVisible() const noexcept { return spectrumVisible; }
+    void setSpectrumVisible(bool shouldBeVisible) noexcept { spectrumVisible = shouldBeVisible; }
+
+    /** Store the current settings as a user preset. Returns its program index, or -1 on failure. */
+    int saveUserPreset(const juce::String& name);
+
 private:
     //==============================================================================
     /** Creates the parameter layout for APVTS */
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    /** Shared body of processBlock and processBlockBypassed */
+    void process(juce::AudioBuffer<float>& buffer, bool hostBypassed);
+
     //==============================================================================
     juce::AudioProcessorValueTreeState apvts;
     Parameters parameters;
-    Compressor compressor;  // Single instance for stereo-linked compression
+    Compressor compressor;  // Single instance, two detector lanes
+    Limiter limiter;        // Output ceiling after makeup
+    LoudnessMeter inputLoudness;
+    LoudnessMeter outputLoudness;
+    Bypass bypass;          // Crossfade to the dry input, latency aligned by the limiter delay
+    juce::AudioProcessorParameter* bypassParameter = nullptr;
     
     /** Atomic gain reduction for thread-safe metering */
     std::atomic<float> gainReductionAtomic{1.0f};
+
+    /** Bus channel counts, read once in prepareToPlay instead of every block */
+    int numInputChannels = 2;
+    int numOutputChannels = 2;
+
+    /** Live gain reduction statistics for the editor */
+    GainReductionStats gainReductionStats;
+
+    /** Result of the last analyse(), shown instead of the live statistics while available */
+    GainReductionStats analysisStats;
+    std::atomic<bool> analysisAvailable { false };
+
+    /** Fed both ends of the chain while the editor shows the spectrum */
+    SpectrumAnalyser spectrumAnalyser;
+
+    /** Fed the linked detector level while learning */
+    ThresholdLearner thresholdLearner;
+
+    /** Blocks that needed repair (audio thread writes, editor reads) */
+    BlockSanitizer::Counters sanitizerCounters;
+
+    /** Shared-memory stats export, inactive unless FIDI_TELEMETRY is set */
+    Telemetry telemetry { apvts };
+
+    /** Factory and user presets, shared by all instances in the process */
+    juce::SharedResourcePointer<PresetBank> presetBank;
+    int currentProgram = 0;
+
+    /** Detector link groups shared with the other instances in the process */
+    juce::SharedResourcePointer<LinkGroups> linkGroups;
+    LinkGroups::Member linkGroupMember { *linkGroups };
+    float groupLevel = 0.0f;            // Loudest level of the other members, as last read
+    float groupPeak = 0.0f;             // Own peak since the last publish
+    int groupExchangeSamples = 0;       // Samples since the last read
+
+    /** Set on the message thread by a program change, consumed by the audio thread */
+    std::atomic<bool> presetMorphPending{false};
+    int presetMorphSamples = 0;
+    static constexpr double presetMorphSeconds = 0.05;  // 50ms crossfade between presets
+
+    float editorScale = 1.0f;
+    bool spectrumVisible = false;
+
+    /** Editor look-and-feel and fonts, held from the first editor open so reopening does not rebuild them */
+    std::unique_ptr<juce::SharedResourcePointer<FIDIEditorStyle>> editorStyle;
+    std::unique_ptr<juce::SharedResourcePointer<FIDILookAndFeel>> editorLookAndFeel;
     
     /** Identifier for XML state */
     static const juce::Identifier stateIdentifier;
 
+   #if FIDI_ENABLE_TRACING
+    /** Writes the Chrome trace to the temp directory when the last instance is destroyed */
+    Trace::Session traceSession;
+   #endif
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FIDICompProcessor)
 };
@@ -0,0 +1,179 @@
+#include "PresetBank.h"
+
+namespace
+{
+    //==============================================================================
+    /** Factory preset: values for the core parameters, other parameters are left as they are */
+    struct FactoryPreset
+    {
+        const char* name;
+        float threshold, ratio, attack, release, knee, makeup, mix;
+    };
+
+    constexpr FactoryPreset factoryPresets[] {
+        //  name                   thresh  ratio  attack  release  knee  makeup  mix
+        { "Default",               -20.0f,  4.0f,  10.0f,  100.0f,  6.0f,  0.0f, 100.0f },
+        { "Vocal Leveler",         -24.0f,  3.0f,   5.0f,  150.0f,  8.0f,  4.0f, 100.0f },
+        { "Drum Bus Glue",         -18.0f,  2.0f,  30.0f,  100.0f,  6.0f,  2.0f, 100.0f },
+        { "Parallel Smash",        -40.0f, 10.0f,   1.0f,   60.0f,  0.0f,  6.0f,  40.0f },
+        { "Bass Control",          -22.0f,  4.0f,  20.0f,  200.0f,  4.0f,  3.0f, 100.0f },
+        { "Fast Peak Catcher",      -8.0f, 20.0f,   0.1f,   50.0f,  2.0f,  0.0f, 100.0f },
+        { "Gentle Master",         -12.0f,  1.5f,  30.0f,  300.0f, 10.0f,  1.0f, 100.0f },
+        { "Slow Opto",             -26.0f,  3.0f,  40.0f,  800.0f, 12.0f,  5.0f, 100.0f },
+    };
+
+    constexpr int numFactoryPresets = static_cast<int>(std::size(factoryPresets));
+
+    StateFormat::Values toValues(const FactoryPreset& preset) noexcept
+    {
+        auto values = StateFormat::makeEmptyValues();
+        const float core[] { preset.threshold, preset.ratio, preset.attack, preset.release,
+                             preset.knee, preset.makeup, preset.mix };
+
+        std::copy(std::begin(core), std::end(core), values.begin());
+        return values;
+    }
+}
+
+//==============================================================================
+juce::File PresetBank::getUserPresetDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("FIDI")
+        .getChildFile("FIDI Comp")
+        .getChildFile("Presets");
+}
+
+//==============================================================================
+void PresetBank::scanUserPresetsIfNeeded()
+{
+    if (hasScanned)
+        return;
+
+    hasScanned = true;
+
+    auto files = getUserPresetDirectory().findChildFiles(juce::File::findFiles, false,
+                                                         juce::String("*") + fileExtension);
+    files.sort();
+
+    userPresets.clear();
+    userPresets.reserve(static_cast<size_t>(files.size()));
+
+    for (const auto& file : files)
+        userPresets.push_back({ file, file.getFileNameWithoutExtension(), false, {} });
+}
+
+//==============================================================================
+int PresetBank::getNumFactoryPresets() const noexcept
+{
+    return numFactoryPresets;
+}
+
+int PresetBank::getNumPresets()
+{
+    const juce::ScopedLock sl(lock);
+    scanUserPresetsIfNeeded();
+    return numFactoryPresets + static_cast<int>(userPresets.size());
+}
+
+juce::String PresetBank::getPresetName(int index)
+{
+    if (juce::isPositiveAndBelow(index, numFactoryPresets))
+        return factoryPresets[index].name;
+
+    const juce::ScopedLock sl(lock);
+    scanUserPresetsIfNeeded();
+
+    const auto userIndex = static_cast<size_t>(index - numFactoryPresets);
+    return index >= numFactoryPresets && userIndex < userPresets.size()
+               ? userPresets[userIndex].name
+               : juce::String();
+}
+
+//==============================================================================
+bool PresetBank::getPresetValues(int index, StateFormat::Values& values)
+{
+    if (juce::isPositiveAndBelow(index, numFactoryPresets))
+    {
+        values = toValues(factoryPresets[index]);
+        return true;
+    }
+
+    const juce::ScopedLock sl(lock);
+    scanUserPresetsIfNeeded();
+
+    const auto userIndex = static_cast<size_t>(index - numFactoryPresets);
+    if (index < numFactoryPresets || userIndex >= userPresets.size())
+        return false;
+
+    auto& preset = userPresets[userIndex];
+
+    if (!preset.isLoaded)
+    {
+        juce::MemoryBlock data;
+        if (!preset.file.loadFileAsData(data)
+            || !StateFormat::parse(data.getData(), static_cast<int>(data.getSize()), preset.values))
+            return false;
+
+        preset.isLoaded = true;
+    }
+
+    values = preset.values;
+    return true;
+}
+
+//==============================================================================
+bool PresetBank::renamePreset(int index, const juce::String& newName)
+{
+    const juce::ScopedLock sl(lock);
+    scanUserPresetsIfNeeded();
+
+    const auto userIndex = static_cast<size_t>(index - numFactoryPresets);
+    const auto safeName = juce::File::createLegalFileName(newName.trim());
+
+    if (index < numFactoryPresets || userIndex >= userPresets.size() || safeName.isEmpty())
+        return false;
+
+    auto& preset = userPresets[userIndex];
+    const auto newFile = preset.file.getSiblingFile(safeName + fileExtension);
+
+    if (newFile.exists() || !preset.file.moveFileTo(newFile))
+        return false;
+
+    preset.file = newFile;
+    preset.name = safeName;
+    return true;
+}
+
+//==============================================================================
+int PresetBank::saveUserPreset(const juce::String& name, const StateFormat::Values& values)
+{
+    const auto safeName = juce::File::createLegalFileName(name.trim());
+    if (safeName.isEmpty())
+        return -1;
+
+    const juce::ScopedLock sl(lock);
+    scanUserPresetsIfNeeded();
+
+    auto directory = getUserPresetDirectory();
+    if (directory.createDirectory().failed())
+        return -1;
+
+    juce::MemoryBlock data;
+    StateFormat::write(values, data);
+
+    const auto file = directory.getChildFile(safeName + fileExtension);
+    if (!file.replaceWithData(data.getData(), data.getSize()))
+        return -1;
+
+    auto existing = std::find_if(userPresets.begin(), userPresets.end(),
+                                 [&file](const UserPreset& p) { return p.file == file; });
+
+    if (existing == userPresets.end())
+        existing = userPresets.insert(userPresets.end(), UserPreset{ file, safeName, false, {} });
+
+    existing->values = values;
+    existing->isLoaded = true;
+
+    return numFactoryPresets + static_cast<int>(std::distance(userPresets.begin(), existing));
+}
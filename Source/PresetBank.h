@@ -0,0 +1,65 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "StateFormat.h"
+
+/**
+ * Preset bank for FIDI Comp
+ * Factory presets are compiled in; user presets are small binary state files
+ * in the user preset folder. The folder is only listed the first time the
+ * bank is queried and each file is read the first time it is selected.
+ * Shared by all instances in the process (use via juce::SharedResourcePointer).
+ */
+class PresetBank
+{
+public:
+    //==============================================================================
+    PresetBank() = default;
+
+    //==============================================================================
+    /** Factory presets followed by user presets */
+    [[nodiscard]] int getNumPresets();
+
+    [[nodiscard]] int getNumFactoryPresets() const noexcept;
+
+    [[nodiscard]] juce::String getPresetName(int index);
+
+    /**
+     * Get the values stored in a preset, loading a user preset file on first use.
+     * @return false if the index is out of range or the file cannot be read
+     */
+    bool getPresetValues(int index, StateFormat::Values& values);
+
+    /** Rename a user preset file. Factory presets cannot be renamed. */
+    bool renamePreset(int index, const juce::String& newName);
+
+    /** Write a new user preset (or overwrite one with the same name). Returns its index. */
+    int saveUserPreset(const juce::String& name, const StateFormat::Values& values);
+
+    //==============================================================================
+    /** Folder scanned for user presets */
+    [[nodiscard]] static juce::File getUserPresetDirectory();
+
+    static constexpr const char* fileExtension = ".fidipreset";
+
+private:
+    //==============================================================================
+    struct UserPreset
+    {
+        juce::File file;
+        juce::String name;
+        bool isLoaded = false;
+        StateFormat::Values values{};
+    };
+
+    /** List preset files on first use (names only; contents are read lazily) */
+    void scanUserPresetsIfNeeded();
+
+    //==============================================================================
+    juce::CriticalSection lock;
+    std::vector<UserPreset> userPresets;
+    bool hasScanned = false;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBank)
+};
@@ -0,0 +1,154 @@
+#include "SharedTables.h"
+
+namespace
+{
+    //==============================================================================
+    /** Key -> weakly held table; a table lives as long as some instance holds it */
+    template <typename Key, typename Table>
+    class TableCache
+    {
+    public:
+        template <typename Factory>
+        std::shared_ptr<const Table> get(const Key& key, Factory&& createTable)
+        {
+            const juce::ScopedLock sl(lock);
+
+            auto& slot = tables[key];
+            if (auto existing = slot.lock())
+                return existing;
+
+            std::shared_ptr<const Table> table = createTable();
+            slot = table;
+            return table;
+        }
+
+    private:
+        juce::CriticalSection lock;
+        std::map<Key, std::weak_ptr<const Table>> tables;
+    };
+
+    template <typename Key, typename Table>
+    TableCache<Key, Table>& getCache()
+    {
+        static TableCache<Key, Table> cache;
+        return cache;
+    }
+
+    double calculateExactCoefficient(double sampleRate, double timeMs) noexcept
+    {
+        return std::exp(-1.0 / (sampleRate * timeMs * 0.001));
+    }
+}
+
+//==============================================================================
+SharedTables::CoefficientTable::CoefficientTable(double newSampleRate)
+    : sampleRate(newSampleRate)
+{
+    for (int i = 0; i < tableSize; ++i)
+    {
+        const int octave = i / stepsPerOctave;
+        const int step = i % stepsPerOctave;
+
+        // Octave starts at 0.5 * 2^exponent ms, steps are linear inside the octave
+        const double timeMs = std::ldexp(0.5 * (1.0 + static_cast<double>(step) / stepsPerOctave),
+                                         octave + minExponent);
+
+        coefficients[static_cast<size_t>(i)] = calculateExactCoefficient(sampleRate, timeMs);
+    }
+}
+
+double SharedTables::CoefficientTable::getCoefficient(double timeMs) const noexcept
+{
+    if (timeMs <= 0.0 || sampleRate <= 0.0)
+        return 0.0;
+
+   #if FIDI_REFERENCE_KERNELS
+    return calculateExactCoefficient(sampleRate, timeMs);
+   #else
+    int exponent = 0;
+    const double mantissa = std::frexp(timeMs, &exponent);  // timeMs = mantissa * 2^exponent, mantissa in [0.5, 1)
+    const int octave = exponent - minExponent;
+
+    // Outside the table (never reached by the parameter ranges): compute exactly
+    if (octave < 0 || octave >= numOctaves)
+        return calculateExactCoefficient(sampleRate, timeMs);
+
+    const double position = (mantissa * 2.0 - 1.0) * stepsPerOctave;
+    const int step = juce::jmin(static_cast<int>(position), stepsPerOctave - 1);
+    const double fraction = position - static_cast<double>(step);
+    const auto index = static_cast<size_t>(octave * stepsPerOctave + step);
+
+    return coefficients[index] + fraction * (coefficients[index + 1] - coefficients[index]);
+   #endif
+}
+
+//==============================================================================
+SharedTables::DecibelTable::DecibelTable()
+{
+    for (int i = 0; i < tableSize; ++i)
+    {
+        const float decibels = minDb + static_cast<float>(i) / stepsPerDb;
+        gains[static_cast<size_t>(i)] = std::pow(10.0f, decibels * 0.05f);
+    }
+}
+
+//==============================================================================
+SharedTables::MeterColourTable::MeterColourTable(int numSegments)
+{
+    colours.reserve(static_cast<size_t>(numSegments));
+
+    for (int i = 0; i < numSegments; ++i)
+    {
+        // Determine segment color based on position with smooth gradient
+        const float position = static_cast<float>(i) / static_cast<float>(numSegments);
+
+        if (position < 0.4f)
+        {
+            // Cyan (low GR)
+            colours.push_back(juce::Colour(0xff00d4ff));
+        }
+        else if (position < 0.65f)
+        {
+            // Blend cyan to yellow
+            const float blend = (position - 0.4f) / 0.25f;
+            colours.push_back(juce::Colour(0xff00d4ff).interpolatedWith(juce::Colour(0xffffcc00), blend));
+        }
+        else if (position < 0.8f)
+        {
+            // Blend yellow to orange
+            const float blend = (position - 0.65f) / 0.15f;
+            colours.push_back(juce::Colour(0xffffcc00).interpolatedWith(juce::Colour(0xffff8800), blend));
+        }
+        else
+        {
+            // Red (high GR)
+            const float blend = (position - 0.8f) / 0.2f;
+            colours.push_back(juce::Colour(0xffff8800).interpolatedWith(juce::Colour(0xffff4444), blend));
+        }
+    }
+}
+
+//==============================================================================
+std::shared_ptr<const SharedTables::CoefficientTable> SharedTables::getCoefficientTable(double sampleRate)
+{
+    return getCache<double, CoefficientTable>().get(sampleRate, [sampleRate]
+    {
+        return std::make_shared<const CoefficientTable>(sampleRate);
+    });
+}
+
+std::shared_ptr<const SharedTables::DecibelTable> SharedTables::getDecibelTable()
+{
+    return getCache<int, DecibelTable>().get(0, []
+    {
+        return std::make_shared<const DecibelTable>();
+    });
+}
+
+std::shared_ptr<const SharedTables::MeterColourTable> SharedTables::getMeterColourTable(int numSegments)
+{
+    return getCache<int, MeterColourTable>().get(numSegments, [numSegments]
+    {
+        return std::make_shared<const MeterColourTable>(numSegments);
+    });
+}
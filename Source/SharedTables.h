@@ -0,0 +1,102 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Reference build: exact math instead of tables and approximations, for comparing renders
+#ifndef FIDI_REFERENCE_KERNELS
+ #define FIDI_REFERENCE_KERNELS 0
+#endif
+
+/**
+ * Process-wide registry of immutable lookup tables for FIDI Comp
+ * Tables are built on first request, shared by every instance asking for the
+ * same key (sample rate, segment count, ...) and freed when the last
+ * instance releases its reference. Requests take a lock and may allocate, so
+ * call the getters from prepareToPlay / constructors, never from the audio
+ * thread. Lookups on a table you already hold are lock-free and const.
+ */
+class SharedTables
+{
+public:
+    //==============================================================================
+    /**
+     * One-pole coefficients exp(-1 / (sampleRate * time)) for one sample rate.
+     * Indexed per octave of time with linear interpolation inside the octave,
+     * so a lookup is a frexp and a lerp instead of std::exp.
+     */
+    class CoefficientTable
+    {
+    public:
+        explicit CoefficientTable(double sampleRate);
+
+        /** Coefficient for a time constant in milliseconds (0 for non-positive times) */
+        [[nodiscard]] double getCoefficient(double timeMs) const noexcept;
+
+        [[nodiscard]] double getSampleRate() const noexcept { return sampleRate; }
+
+        static constexpr int minExponent = -3;          // 0.0625 ms
+        static constexpr int numOctaves = 20;           // up to 65 s
+        static constexpr int stepsPerOctave = 64;
+        static constexpr int tableSize = numOctaves * stepsPerOctave + 1;
+
+    private:
+        double sampleRate;
+        std::array<double, tableSize> coefficients{};
+    };
+
+    //==============================================================================
+    /** dB to linear gain with 1/16 dB resolution (error below 0.0001 dB) */
+    class DecibelTable
+    {
+    public:
+        DecibelTable();
+
+        /** Linear gain for a level in dB, clamped to the table range */
+        [[nodiscard]] float decibelsToGain(float decibels) const noexcept
+        {
+            // Argument order makes NaN clamp to minDb
+            const float clamped = std::min(maxDb, std::max(minDb, decibels));
+
+           #if FIDI_REFERENCE_KERNELS
+            return std::pow(10.0f, clamped * 0.05f);
+           #else
+            const float position = (clamped - minDb) * stepsPerDb;
+            const int index = juce::jmin(static_cast<int>(position), tableSize - 2);
+            const float fraction = position - static_cast<float>(index);
+
+            return gains[static_cast<size_t>(index)]
+                 + fraction * (gains[static_cast<size_t>(index + 1)] - gains[static_cast<size_t>(index)]);
+           #endif
+        }
+
+        static constexpr float minDb = -128.0f;
+        static constexpr float maxDb = 64.0f;
+        static constexpr float stepsPerDb = 16.0f;
+        static constexpr int tableSize = static_cast<int>((maxDb - minDb) * stepsPerDb) + 1;
+
+    private:
+        std::array<float, tableSize> gains{};
+    };
+
+    //==============================================================================
+    /** Colour of each LED segment of the gain reduction meter */
+    class MeterColourTable
+    {
+    public:
+        explicit MeterColourTable(int numSegments);
+
+        [[nodiscard]] juce::Colour getColour(int segment) const noexcept { return colours[static_cast<size_t>(segment)]; }
+        [[nodiscard]] int getNumSegments() const noexcept { return static_cast<int>(colours.size()); }
+
+    private:
+        std::vector<juce::Colour> colours;
+    };
+
+    //==============================================================================
+    [[nodiscard]] static std::shared_ptr<const CoefficientTable> getCoefficientTable(double sampleRate);
+    [[nodiscard]] static std::shared_ptr<const DecibelTable> getDecibelTable();
+    [[nodiscard]] static std::shared_ptr<const MeterColourTable> getMeterColourTable(int numSegments);
+
+private:
+    SharedTables() = delete;
+};
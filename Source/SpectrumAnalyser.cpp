@@ -0,0 +1,292 @@
+#include "SpectrumAnalyser.h"
+#include "Trace.h"
+
+//==============================================================================
+SpectrumAnalyser::AnalysisThread::AnalysisThread()
+    : juce::TimeSliceThread("FIDI Comp Spectrum")
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+SpectrumAnalyser::AnalysisThread::~AnalysisThread()
+{
+    stopThread(1000);
+}
+
+//==============================================================================
+SpectrumAnalyser::SpectrumAnalyser()
+{
+    // Room for every path point, so rebuilding a path never allocates
+    for (auto* path : { &analyses[0].path, &analyses[1].path, &publishedInputPath, &publishedOutputPath })
+        path->preallocateSpace(3 * (numPoints + 4));
+
+    analysisThread->addTimeSliceClient(this);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    // Waits for a running analysis slice to finish
+    analysisThread->removeTimeSliceClient(this);
+}
+
+//==============================================================================
+void SpectrumAnalyser::prepare(double sampleRate)
+{
+    currentSampleRate.store(sampleRate);
+    resetPending.store(true);
+}
+
+void SpectrumAnalyser::setActive(bool shouldBeActive) noexcept
+{
+    // Start from silence rather than from whatever played when it was last shown
+    if (shouldBeActive && ! active.load())
+        resetPending.store(true);
+
+    active.store(shouldBeActive);
+}
+
+void SpectrumAnalyser::push(Source source, const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (! active.load(std::memory_order_relaxed) || numChannels <= 0)
+        return;
+
+    auto& target = fifos[static_cast<size_t>(source)];
+
+    // A full FIFO (analysis thread stalled) drops the rest of the block
+    int start1, size1, start2, size2;
+    target.fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    const float scale = 1.0f / static_cast<float>(numChannels);
+
+    auto copyMono = [&](int start, int size, int offset)
+    {
+        if (size <= 0)
+            return;
+
+        float* destination = target.data.data() + start;
+        juce::FloatVectorOperations::copyWithMultiply(destination, channels[0] + offset, scale, size);
+
+        for (int ch = 1; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::addWithMultiply(destination, channels[ch] + offset, scale, size);
+    };
+
+    copyMono(start1, size1, 0);
+    copyMono(start2, size2, size1);
+
+    target.fifo.finishedWrite(size1 + size2);
+}
+
+bool SpectrumAnalyser::getPaths(juce::Path& inputPath, juce::Path& outputPath, juce::uint32& lastVersion)
+{
+    if (version.load(std::memory_order_acquire) == lastVersion)
+        return false;
+
+    const juce::SpinLock::ScopedLockType lock(pathLock);
+
+    inputPath = publishedInputPath;
+    outputPath = publishedOutputPath;
+    lastVersion = version.load(std::memory_order_relaxed);
+    return true;
+}
+
+//==============================================================================
+int SpectrumAnalyser::useTimeSlice()
+{
+    FIDI_TRACE_SCOPE("SpectrumAnalyser::useTimeSlice");
+
+    if (! active.load())
+    {
+        // Drop anything pushed just before the editor went away
+        for (auto& source : fifos)
+            source.fifo.finishedRead(source.fifo.getNumReady());
+
+        return idleMilliseconds;
+    }
+
+    if (resetPending.exchange(false))
+    {
+        updateGrid(currentSampleRate.load());
+
+        for (auto& analysis : analyses)
+        {
+            analysis.history.fill(0.0f);
+            analysis.historyPosition = 0;
+            analysis.hasNewSamples = false;
+            analysis.levels.fill(minDb);
+        }
+    }
+
+    // Keep the latest fftSize samples of each source
+    for (size_t source = 0; source < fifos.size(); ++source)
+    {
+        auto& fifo = fifos[source];
+        auto& analysis = analyses[source];
+
+        int start1, size1, start2, size2;
+        fifo.fifo.prepareToRead(fifo.fifo.getNumReady(), start1, size1, start2, size2);
+
+        auto append = [&](int start, int size)
+        {
+            // Only the tail of a long run can survive in the history
+            if (size > fftSize)
+            {
+                start += size - fftSize;
+                size = fftSize;
+            }
+
+            while (size > 0)
+            {
+                const int chunk = std::min(size, fftSize - analysis.historyPosition);
+                std::copy_n(fifo.data.data() + start, chunk, analysis.history.data() + analysis.historyPosition);
+                analysis.historyPosition = (analysis.historyPosition + chunk) % fftSize;
+                start += chunk;
+                size -= chunk;
+            }
+        };
+
+        append(start1, size1);
+        append(start2, size2);
+        fifo.fifo.finishedRead(size1 + size2);
+
+        if (size1 + size2 > 0)
+            analysis.hasNewSamples = true;
+    }
+
+    std::array<bool, numSources> rebuilt {};
+
+    // Paused transport or full bypass: no new samples, no new frame, no repaint
+    for (int source = 0; source < numSources; ++source)
+    {
+        auto& analysis = analyses[static_cast<size_t>(source)];
+
+        if (! analysis.hasNewSamples)
+            continue;
+
+        analysis.hasNewSamples = false;
+        analyse(source);
+        buildPath(source);
+        rebuilt[static_cast<size_t>(source)] = true;
+    }
+
+    if (rebuilt[input] || rebuilt[output])
+    {
+        const juce::SpinLock::ScopedLockType lock(pathLock);
+
+        // Swapped, so the analysis side keeps reusing the published paths' storage. A path
+        // not rebuilt this slice holds an older frame and must not replace the published one.
+        if (rebuilt[input])
+            publishedInputPath.swapWithPath(analyses[static_cast<size_t>(input)].path);
+
+        if (rebuilt[output])
+            publishedOutputPath.swapWithPath(analyses[static_cast<size_t>(output)].path);
+
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    return sliceMilliseconds;
+}
+
+//==============================================================================
+void SpectrumAnalyser::updateGrid(double sampleRate) noexcept
+{
+    if (sampleRate == gridSampleRate)
+        return;
+
+    gridSampleRate = sampleRate;
+
+    const float binsPerHz = static_cast<float>(fftSize / sampleRate);
+    const float topFrequency = std::min(maxFrequency, static_cast<float>(sampleRate * 0.5));
+    const float lastBin = static_cast<float>(fftSize / 2 - 1);
+
+    auto getFrequency = [](float point)
+    {
+        return minFrequency * std::pow(maxFrequency / minFrequency, point / static_cast<float>(numPoints - 1));
+    };
+
+    for (int point = 0; point < numPoints; ++point)
+    {
+        const float lower = std::min(getFrequency(static_cast<float>(point) - 0.5f), topFrequency);
+        const float centre = std::min(getFrequency(static_cast<float>(point)), topFrequency);
+        const float upper = std::min(getFrequency(static_cast<float>(point) + 0.5f), topFrequency);
+
+        pointBins[static_cast<size_t>(point)] = std::min(centre * binsPerHz, lastBin);
+        firstBins[static_cast<size_t>(point)] = static_cast<int>(std::ceil(lower * binsPerHz));
+        lastBins[static_cast<size_t>(point)] = std::min(static_cast<int>(std::floor(upper * binsPerHz)), fftSize / 2);
+    }
+}
+
+void SpectrumAnalyser::analyse(int source) noexcept
+{
+    auto& analysis = analyses[static_cast<size_t>(source)];
+
+    // Oldest sample first
+    const int tail = fftSize - analysis.historyPosition;
+    std::copy_n(analysis.history.data() + analysis.historyPosition, tail, fftData.data());
+    std::copy_n(analysis.history.data(), analysis.historyPosition, fftData.data() + tail);
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+    window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // A full scale sine reads 0 dB: Hann's coherent gain is 1/2, a real sine splits over +-f
+    constexpr float magnitudeScale = 4.0f / static_cast<float>(fftSize);
+
+    for (int point = 0; point < numPoints; ++point)
+    {
+        const auto p = static_cast<size_t>(point);
+        float magnitude = 0.0f;
+
+        if (lastBins[p] > firstBins[p])
+        {
+            // Several bins per point: the loudest, so narrow peaks are not averaged away
+            for (int bin = firstBins[p]; bin <= lastBins[p]; ++bin)
+                magnitude = std::max(magnitude, fftData[static_cast<size_t>(bin)]);
+        }
+        else
+        {
+            // Bins wider than the point: interpolate between the nearest two
+            const int bin = static_cast<int>(pointBins[p]);
+            const float fraction = pointBins[p] - static_cast<float>(bin);
+            magnitude = fftData[static_cast<size_t>(bin)]
+                      + fraction * (fftData[static_cast<size_t>(bin + 1)] - fftData[static_cast<size_t>(bin)]);
+        }
+
+        const float levelDb = juce::jlimit(minDb, maxDb, juce::Decibels::gainToDecibels(magnitude * magnitudeScale, minDb));
+
+        // Fast rise, slow fall, per frame
+        auto& level = analysis.levels[p];
+        level += (levelDb > level ? attackCoeff : releaseCoeff) * (levelDb - level);
+    }
+}
+
+void SpectrumAnalyser::buildPath(int source) noexcept
+{
+    auto& analysis = analyses[static_cast<size_t>(source)];
+    auto& path = analysis.path;
+
+    path.clear();
+
+    auto getPoint = [&analysis](int point)
+    {
+        return juce::Point<float>(static_cast<float>(point) / static_cast<float>(numPoints - 1),
+                                  (maxDb - analysis.levels[static_cast<size_t>(point)]) / (maxDb - minDb));
+    };
+
+    if (source == input)
+    {
+        path.startNewSubPath(0.0f, 1.0f);
+
+        for (int point = 0; point < numPoints; ++point)
+            path.lineTo(getPoint(point));
+
+        path.lineTo(1.0f, 1.0f);
+        path.closeSubPath();
+    }
+    else
+    {
+        path.startNewSubPath(getPoint(0));
+
+        for (int point = 1; point < numPoints; ++point)
+            path.lineTo(getPoint(point));
+    }
+}
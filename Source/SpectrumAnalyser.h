@@ -0,0 +1,134 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Input/output spectrum analysis for FIDI Comp's editor
+ * Only active while an editor shows the spectrum. The audio thread then
+ * copies a mono mix of each block into a preallocated lock-free FIFO per
+ * source, nothing more; while inactive, push() returns at once. A low-priority
+ * thread drains the FIFOs at display rate, windows the latest samples, runs
+ * juce::dsp::FFT, smooths the levels on a log frequency grid and builds the
+ * paths the editor draws. Paths are handed over under a spin lock with a
+ * version number, so the editor only copies and repaints when there is a new
+ * frame.
+ */
+class SpectrumAnalyser : private juce::TimeSliceClient
+{
+public:
+    //==============================================================================
+    enum Source
+    {
+        input = 0,                      // Before compression
+        output,                         // After the ceiling
+        numSources
+    };
+
+    SpectrumAnalyser();
+    ~SpectrumAnalyser() override;
+
+    //==============================================================================
+    /** Set the sample rate for the frequency grid and clear the history (not on the audio thread) */
+    void prepare(double sampleRate);
+
+    /** Start or stop analysis (message thread, while an editor shows the spectrum) */
+    void setActive(bool shouldBeActive) noexcept;
+
+    [[nodiscard]] bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    /** Copy a block of a source (audio thread, no-op unless active) */
+    void push(Source source, const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /**
+     * Copy the latest paths if there is a frame newer than lastVersion (message
+     * thread). Paths are in unit space: x is log frequency from minFrequency
+     * (0) to maxFrequency (1), y is level from maxDb (0) to minDb (1). The input
+     * path is closed along y = 1 for filling; the output path is an open line.
+     */
+    bool getPaths(juce::Path& inputPath, juce::Path& outputPath, juce::uint32& lastVersion);
+
+    //==============================================================================
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float minDb = -84.0f;
+    static constexpr float maxDb = 0.0f;
+
+private:
+    //==============================================================================
+    int useTimeSlice() override;
+
+    /** Map the log frequency grid to FFT bins (analysis thread) */
+    void updateGrid(double sampleRate) noexcept;
+
+    /** Window, transform and smooth the latest samples of a source (analysis thread) */
+    void analyse(int source) noexcept;
+
+    /** Rebuild a source's path from its smoothed levels (analysis thread) */
+    void buildPath(int source) noexcept;
+
+    //==============================================================================
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;       // 2048: ~23 Hz bins at 48kHz
+    static constexpr int numPoints = 96;                // Log frequency grid
+    static constexpr int sliceMilliseconds = 33;        // ~30 frames per second while active
+    static constexpr int idleMilliseconds = 200;
+
+    // Blocks, audio thread -> analysis thread (~80ms at 192kHz, several slices)
+    static constexpr int fifoSize = 16384;
+
+    struct Fifo
+    {
+        juce::AbstractFifo fifo { fifoSize };
+        std::array<float, fifoSize> data{};
+    };
+
+    std::array<Fifo, numSources> fifos;
+
+    std::atomic<bool> active { false };
+    std::atomic<bool> resetPending { true };
+    std::atomic<double> currentSampleRate { 48000.0 };
+
+    // Analysis thread state
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false };
+    std::array<float, 2 * fftSize> fftData{};
+
+    struct Analysis
+    {
+        std::array<float, fftSize> history{};           // Latest samples, circular
+        int historyPosition = 0;
+        bool hasNewSamples = false;
+        std::array<float, numPoints> levels{};          // Smoothed, dB
+        juce::Path path;
+    };
+
+    std::array<Analysis, numSources> analyses;
+
+    // Bin range of each grid point; fractional below the point where bins are wider than it
+    std::array<float, numPoints> pointBins{};
+    std::array<int, numPoints> firstBins{};
+    std::array<int, numPoints> lastBins{};
+    double gridSampleRate = 0.0;
+
+    // Level ballistics per frame at the active slice rate
+    static constexpr float attackCoeff = 0.7f;          // ~30ms
+    static constexpr float releaseCoeff = 0.12f;        // ~250ms
+
+    // Published paths
+    juce::SpinLock pathLock;
+    juce::Path publishedInputPath;
+    juce::Path publishedOutputPath;
+    std::atomic<juce::uint32> version { 0 };
+
+    /** One low-priority thread for the analysers of every instance in the process */
+    struct AnalysisThread : public juce::TimeSliceThread
+    {
+        AnalysisThread();
+        ~AnalysisThread() override;
+    };
+
+    juce::SharedResourcePointer<AnalysisThread> analysisThread;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyser)
+};
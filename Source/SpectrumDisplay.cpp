@@ -0,0 +1,66 @@
+#include "SpectrumDisplay.h"
+#include "Trace.h"
+
+SpectrumDisplay::SpectrumDisplay(SpectrumAnalyser& spectrumAnalyser)
+    : analyser(spectrumAnalyser)
+{
+    setInterceptsMouseClicks(false, false);
+
+    // Hidden until the editor turns it on
+    setVisible(false);
+}
+
+SpectrumDisplay::~SpectrumDisplay()
+{
+    stopTimer();
+    analyser.setActive(false);
+}
+
+//==============================================================================
+void SpectrumDisplay::visibilityChanged()
+{
+    const bool visible = isVisible();
+    analyser.setActive(visible);
+
+    if (visible)
+    {
+        startTimerHz(timerRateHz);
+    }
+    else
+    {
+        // Stale paths are not drawn when it is turned on again
+        stopTimer();
+        inputPath.clear();
+        outputPath.clear();
+    }
+}
+
+void SpectrumDisplay::timerCallback()
+{
+    if (analyser.getPaths(inputPath, outputPath, pathVersion))
+        repaint();
+}
+
+//==============================================================================
+void SpectrumDisplay::paint(juce::Graphics& g)
+{
+    FIDI_TRACE_SCOPE("SpectrumDisplay::paint");
+
+    // Inside the meter's border, as the meter draws it
+    const auto bounds = getLocalBounds().toFloat().reduced(3.0f);
+
+    if (inputPath.isEmpty() || bounds.isEmpty())
+        return;
+
+    // Unit space x (log frequency) runs bottom to top, y (level from the top) left to right
+    const juce::AffineTransform toBounds(0.0f, -bounds.getWidth(), bounds.getRight(),
+                                         -bounds.getHeight(), 0.0f, bounds.getBottom());
+
+    g.reduceClipRegion(bounds.toNearestInt());
+
+    g.setColour(juce::Colour(0x1cffffff));
+    g.fillPath(inputPath, toBounds);
+
+    g.setColour(juce::Colour(0xa000d4ff));
+    g.strokePath(outputPath, juce::PathStrokeType(1.2f, juce::PathStrokeType::curved), toBounds);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SpectrumAnalyser.h"
+
+/**
+ * Spectrum overlay behind FIDI Comp's gain reduction meter
+ * Drawn along the meter: frequency rises from bottom to top, level grows to
+ * the right. The input is a faint fill and the output a line over it. The
+ * analyser only runs while this component is visible; a 30 Hz timer copies
+ * its paths and repaints only when it has produced a new frame.
+ */
+class SpectrumDisplay : public juce::Component, private juce::Timer
+{
+public:
+    //==============================================================================
+    explicit SpectrumDisplay(SpectrumAnalyser& analyser);
+    ~SpectrumDisplay() override;
+
+    //==============================================================================
+    void paint(juce::Graphics& g) override;
+    void visibilityChanged() override;
+
+private:
+    //==============================================================================
+    void timerCallback() override;
+
+    //==============================================================================
+    SpectrumAnalyser& analyser;
+
+    juce::Path inputPath;               // Unit space, as handed over by the analyser
+    juce::Path outputPath;
+    juce::uint32 pathVersion = 0;
+
+    static constexpr int timerRateHz = 30;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumDisplay)
+};
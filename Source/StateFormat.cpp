@@ -0,0 +1,102 @@
+#include "StateFormat.h"
+
+//==============================================================================
+void StateFormat::write(juce::AudioProcessorValueTreeState& apvts, juce::MemoryBlock& destData)
+{
+    Values values;
+    capture(apvts, values);
+    write(values, destData);
+}
+
+void StateFormat::write(const Values& values, juce::MemoryBlock& destData)
+{
+    destData.setSize(0);
+    destData.ensureSize(static_cast<size_t>(headerSize) + values.size() * sizeof(float));
+
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(static_cast<int>(magic));
+    stream.writeShort(static_cast<short>(currentVersion));
+    stream.writeShort(static_cast<short>(values.size()));
+
+    for (const float value : values)
+        stream.writeFloat(value);
+}
+
+//==============================================================================
+bool StateFormat::isBinaryState(const void* data, int sizeInBytes) noexcept
+{
+    return data != nullptr
+        && sizeInBytes >= headerSize
+        && juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+StateFormat::Values StateFormat::makeEmptyValues() noexcept
+{
+    Values values;
+    values.fill(std::numeric_limits<float>::quiet_NaN());
+    return values;
+}
+
+//==============================================================================
+bool StateFormat::parse(const void* data, int sizeInBytes, Values& values) noexcept
+{
+    if (!isBinaryState(data, sizeInBytes))
+        return false;
+
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+    stream.skipNextBytes(4);  // magic
+
+    const auto version = static_cast<juce::uint16>(stream.readShort());
+    const auto numValues = static_cast<int>(static_cast<juce::uint16>(stream.readShort()));
+
+    if (version == 0 || version > currentVersion)
+        return false;
+
+    if (sizeInBytes < headerSize + numValues * static_cast<int>(sizeof(float)))
+        return false;
+
+    values = makeEmptyValues();
+
+    for (int i = 0; i < juce::jmin(numValues, static_cast<int>(values.size())); ++i)
+        values[static_cast<size_t>(i)] = stream.readFloat();
+
+    return true;
+}
+
+//==============================================================================
+void StateFormat::capture(juce::AudioProcessorValueTreeState& apvts, Values& values) noexcept
+{
+    for (size_t i = 0; i < parameterOrder.size(); ++i)
+        values[i] = apvts.getRawParameterValue(parameterOrder[i])->load();
+}
+
+//==============================================================================
+void StateFormat::apply(juce::AudioProcessorValueTreeState& apvts, const Values& values,
+                        bool resetMissingToDefault)
+{
+    for (size_t i = 0; i < parameterOrder.size(); ++i)
+    {
+        auto* param = apvts.getParameter(parameterOrder[i]);
+        if (param == nullptr)
+            continue;
+
+        const float value = values[i];
+
+        // Write the value straight into the parameter; the ValueTree catches up lazily
+        if (std::isfinite(value))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+        else if (resetMissingToDefault)
+            param->setValueNotifyingHost(param->getDefaultValue());
+    }
+}
+
+//==============================================================================
+bool StateFormat::read(juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes)
+{
+    Values values;
+    if (!parse(data, sizeInBytes, values))
+        return false;
+
+    apply(apvts, values, true);
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Compact binary state format for FIDI Comp
+ * Layout (little-endian): magic "FDCS", uint16 version, uint16 value count,
+ * followed by one float32 per parameter in parameterOrder. Values are stored
+ * in plain units (dB, ms, %) so the layout survives range changes. New
+ * parameters are only ever appended; the version changes only if the
+ * meaning of existing slots does. Used for plugin state and preset files.
+ */
+class StateFormat
+{
+public:
+    //==============================================================================
+    static constexpr juce::uint32 magic = 0x53434446;   // 'F' 'D' 'C' 'S'
+    static constexpr juce::uint16 currentVersion = 1;
+    static constexpr int headerSize = 8;
+
+    /** Parameter IDs in their fixed on-disk order */
+    static constexpr std::array<const char*, 22> parameterOrder {
+        "threshold", "ratio", "attack", "release", "knee", "makeup", "mix",
+        "link", "stereoMode", "limiter", "ceiling",
+        "expThreshold", "expRatio", "upwardRatio", "linkGroup",
+        "autoRelease", "autoMakeup", "quality", "offlineHigh",
+        "detector", "detectorDomain", "topology"
+    };
+
+    /** Plain parameter values in parameterOrder; NaN marks a slot that is not present */
+    using Values = std::array<float, parameterOrder.size()>;
+
+    //==============================================================================
+    /** Serialise the current parameter values without touching the ValueTree */
+    static void write(juce::AudioProcessorValueTreeState& apvts, juce::MemoryBlock& destData);
+
+    /** Serialise a set of values (missing slots are written as NaN) */
+    static void write(const Values& values, juce::MemoryBlock& destData);
+
+    /**
+     * Restore parameter values directly from binary state.
+     * Parameters missing from older states are reset to their defaults.
+     * @return false if the data is not in this format (caller should fall back to XML)
+     */
+    static bool read(juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes);
+
+    /** Decode binary state into values without applying it. Returns false if the data is not valid. */
+    static bool parse(const void* data, int sizeInBytes, Values& values) noexcept;
+
+    /** Read the current plain parameter values */
+    static void capture(juce::AudioProcessorValueTreeState& apvts, Values& values) noexcept;
+
+    /**
+     * Write values into the parameters (notifying the host).
+     * @param resetMissingToDefault If true NaN slots reset to default, otherwise they are left untouched
+     */
+    static void apply(juce::AudioProcessorValueTreeState& apvts, const Values& values, bool resetMissingToDefault);
+
+    /** True if the data starts with the binary state header */
+    [[nodiscard]] static bool isBinaryState(const void* data, int sizeInBytes) noexcept;
+
+    /** Values with every slot marked as missing */
+    [[nodiscard]] static Values makeEmptyValues() noexcept;
+
+private:
+    StateFormat() = delete;
+};
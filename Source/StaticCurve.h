@@ -0,0 +1,86 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Static gain curve for FIDI Comp
+ * One multi-segment transfer curve covering three dynamics processors:
+ *  - downward expansion / gating below the expander threshold
+ *  - optional upward compression between the expander and main thresholds
+ *  - soft-knee compression above the main threshold
+ * Every segment is evaluated for every sample and combined with min/max and
+ * selects, so a block of levels goes through one branchless loop.
+ */
+struct StaticCurve
+{
+    //==============================================================================
+    static constexpr float maxExpansionDb = 80.0f;      // Gate range
+
+    /** Build the curve, precomputing slopes so the per-sample path has no setup */
+    static StaticCurve create(float threshold, float ratio, float knee,
+                              float expanderThreshold, float expanderRatio,
+                              float upwardRatio) noexcept
+    {
+        StaticCurve curve;
+        curve.threshold = threshold;
+        curve.halfKnee = knee * 0.5f;
+        curve.knee = knee;
+        curve.inverseKnee = knee > 0.0f ? 1.0f / knee : 0.0f;
+        curve.compressionSlope = 1.0f - 1.0f / ratio;
+        curve.expanderThreshold = expanderThreshold;
+        curve.expansionSlope = expanderRatio - 1.0f;
+        curve.upwardSlope = 1.0f - 1.0f / upwardRatio;
+        curve.upwardRange = std::max(threshold - expanderThreshold, 0.0f);
+        return curve;
+    }
+
+    //==============================================================================
+    /**
+     * Gain change for an input level.
+     * @param inputDb Detector level in dB
+     * @return Gain in dB: negative for compression/expansion, positive for upward boost
+     */
+    [[nodiscard]] float getGainDb(float inputDb) const noexcept
+    {
+        return getUpwardGainDb(inputDb) - getCompressionDb(inputDb) - getExpansionDb(inputDb);
+    }
+
+    /** Reduction from the compression segment alone (positive dB) */
+    [[nodiscard]] float getCompressionDb(float inputDb) const noexcept
+    {
+        // Quadratic soft knee: the slope grows linearly from 0 to the full ratio's across
+        // the knee, which meets both neighbouring segments in value and slope. Zero below it.
+        const float kneePosition = std::clamp(inputDb - (threshold - halfKnee), 0.0f, knee);
+        const float inKneeDb = 0.5f * compressionSlope * kneePosition * kneePosition * inverseKnee;
+
+        // Above the knee: full ratio
+        const float aboveKneeDb = (inputDb - threshold) * compressionSlope;
+
+        return inputDb >= threshold + halfKnee ? aboveKneeDb : inKneeDb;
+    }
+
+    /** Reduction from the downward expander (positive dB, limited to the gate range) */
+    [[nodiscard]] float getExpansionDb(float inputDb) const noexcept
+    {
+        const float belowDb = std::max(expanderThreshold - inputDb, 0.0f);
+        return std::min(belowDb * expansionSlope, maxExpansionDb);
+    }
+
+    /** Boost from upward compression (positive dB), held constant below the expander threshold */
+    [[nodiscard]] float getUpwardGainDb(float inputDb) const noexcept
+    {
+        const float underDb = std::clamp(threshold - inputDb, 0.0f, upwardRange);
+        return underDb * upwardSlope;
+    }
+
+    //==============================================================================
+    float threshold = -20.0f;
+    float halfKnee = 3.0f;
+    float knee = 6.0f;
+    float inverseKnee = 1.0f / 6.0f;
+    float compressionSlope = 0.75f;
+    float expanderThreshold = -60.0f;
+    float expansionSlope = 0.0f;
+    float upwardSlope = 0.0f;
+    float upwardRange = 40.0f;
+};
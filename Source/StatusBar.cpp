@@ -0,0 +1,150 @@
+#include "StatusBar.h"
+#include "Trace.h"
+
+//==============================================================================
+StatusBar::StatusBar(LoudnessMeter& inputMeter, LoudnessMeter& outputMeter, GainReductionStats& stats,
+                     GainReductionStats& analysis, std::atomic<bool>& analysisReady,
+                     const BlockSanitizer::Counters& counters)
+    : inputLoudness(inputMeter),
+      outputLoudness(outputMeter),
+      gainReductionStats(stats),
+      analysisStats(analysis),
+      analysisAvailable(analysisReady),
+      sanitizerCounters(counters)
+{
+    setTooltip("Click to reset integrated loudness and gain reduction statistics");
+    startTimerHz(timerRateHz);
+}
+
+StatusBar::~StatusBar()
+{
+    stopTimer();
+}
+
+//==============================================================================
+void StatusBar::timerCallback()
+{
+    inputReadings = inputLoudness.getReadings();
+    outputReadings = outputLoudness.getReadings();
+    showingAnalysis = analysisAvailable.load();
+    gainReductionSummary = showingAnalysis ? analysisStats.getSummary() : gainReductionStats.getSummary();
+
+    // Repaired blocks since load: NaN/Inf in, NaN/Inf out, denormal out, detector resets
+    const auto nonFiniteIn = sanitizerCounters.nonFiniteInputBlocks.load(std::memory_order_relaxed);
+    const auto nonFiniteOut = sanitizerCounters.nonFiniteOutputBlocks.load(std::memory_order_relaxed);
+    const auto denormalOut = sanitizerCounters.denormalOutputBlocks.load(std::memory_order_relaxed);
+    const auto resets = sanitizerCounters.detectorResets.load(std::memory_order_relaxed);
+
+    if (nonFiniteIn + nonFiniteOut + denormalOut + resets > 0)
+        diagnosticsText = "NAN IN " + juce::String(nonFiniteIn) + "  OUT " + juce::String(nonFiniteOut)
+                        + "  DENORM " + juce::String(denormalOut) + "  RESET " + juce::String(resets);
+
+    repaint();
+}
+
+void StatusBar::mouseDown(const juce::MouseEvent& event)
+{
+    juce::ignoreUnused(event);
+
+    inputLoudness.resetIntegration();
+    outputLoudness.resetIntegration();
+    gainReductionStats.reset();
+    analysisAvailable.store(false);
+}
+
+//==============================================================================
+juce::String StatusBar::formatLufs(float lufs)
+{
+    if (lufs <= LoudnessMeter::noReading)
+        return "--";
+
+    return juce::String(lufs, 1);
+}
+
+void StatusBar::drawReadings(juce::Graphics& g, juce::Rectangle<int> area, const juce::String& title,
+                             const LoudnessMeter::Readings& readings) const
+{
+    g.setColour(juce::Colour(0xff00d4ff));
+    g.setFont(style->captionFont);
+    g.drawText(title, area.removeFromLeft(32), juce::Justification::centredLeft);
+
+    g.setColour(juce::Colour(0x99ffffff));
+    g.setFont(style->smallFont);
+    g.drawText("M " + formatLufs(readings.momentary)
+                   + "   S " + formatLufs(readings.shortTerm)
+                   + "   I " + formatLufs(readings.integrated) + " LUFS"
+                   + "   LRA " + juce::String(readings.range, 1) + " LU",
+               area, juce::Justification::centredLeft);
+}
+
+void StatusBar::drawGainReduction(juce::Graphics& g, juce::Rectangle<int> area) const
+{
+    const auto& summary = gainReductionSummary;
+
+    g.setColour(juce::Colour(0xff00d4ff));
+    g.setFont(style->captionFont);
+    g.drawText(showingAnalysis ? "FILE" : "GR", area.removeFromLeft(32), juce::Justification::centredLeft);
+
+    // Histogram, heights relative to the fullest bin
+    auto histogramArea = area.removeFromLeft(histogramBars * 3).reduced(0, 4);
+    juce::uint64 fullest = 1;
+
+    for (const auto count : summary.histogram)
+        fullest = std::max(fullest, count);
+
+    g.setColour(juce::Colour(0x33ffffff));
+    g.fillRect(histogramArea.withTop(histogramArea.getBottom() - 1));
+    g.setColour(juce::Colour(0xff00d4ff).withAlpha(0.7f));
+
+    for (int bar = 0; bar < histogramBars; ++bar)
+    {
+        juce::uint64 count = 0;
+
+        for (int i = 0; i < histogramBinsPerBar; ++i)
+            count += summary.histogram[static_cast<size_t>(bar * histogramBinsPerBar + i)];
+
+        const float height = static_cast<float>(histogramArea.getHeight())
+                           * static_cast<float>(static_cast<double>(count) / static_cast<double>(fullest));
+        g.fillRect(juce::Rectangle<float>(static_cast<float>(histogramArea.getX() + bar * 3),
+                                          static_cast<float>(histogramArea.getBottom()) - height,
+                                          2.0f, height));
+    }
+
+    area.removeFromLeft(10);
+    g.setColour(juce::Colour(0x99ffffff));
+    g.setFont(style->smallFont);
+    g.drawText("PEAK " + juce::String(summary.peakDb, 1) + " dB"
+                   + "   AVG " + juce::String(summary.averageDb, 1) + " dB"
+                   + "   COMPRESSING " + juce::String(juce::roundToInt(summary.getCompressingFraction() * 100.0)) + "%",
+               area, juce::Justification::centredLeft);
+}
+
+void StatusBar::paint(juce::Graphics& g)
+{
+    FIDI_TRACE_SCOPE("StatusBar::paint");
+
+    auto bounds = getLocalBounds();
+
+    // Background and top border
+    g.setColour(juce::Colour(0x15ffffff));
+    g.fillRect(bounds);
+    g.setColour(juce::Colour(0xff333344));
+    g.drawHorizontalLine(0, 0.0f, static_cast<float>(getWidth()));
+
+    auto content = bounds.reduced(25, 0);
+    auto loudnessRow = content.removeFromTop(content.getHeight() / 2);
+
+    const int halfWidth = loudnessRow.getWidth() / 2;
+
+    drawReadings(g, loudnessRow.removeFromLeft(halfWidth), "IN", inputReadings);
+    drawReadings(g, loudnessRow, "OUT", outputReadings);
+
+    if (diagnosticsText.isNotEmpty())
+    {
+        g.setColour(juce::Colour(0xffff6b6b));
+        g.setFont(style->sectionFont);
+        g.drawText(diagnosticsText, content.removeFromRight(170), juce::Justification::centredRight);
+    }
+
+    drawGainReduction(g, content);
+}
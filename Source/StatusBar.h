@@ -0,0 +1,71 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "BlockSanitizer.h"
+#include "GainReductionStats.h"
+#include "LookAndFeel.h"
+#include "LoudnessMeter.h"
+
+/**
+ * Status bar component for FIDI Comp
+ * Shows input and output loudness (momentary, short-term, integrated and
+ * loudness range) along the bottom of the editor, with a second row of gain
+ * reduction statistics (peak, average, time in compression and a histogram),
+ * plus the sanitizer counters once a block has needed repair. Once an offline
+ * analysis has finished its statistics replace the live ones. Click to
+ * restart the integrated measurement and the statistics (and to go back from
+ * an analysis to the live statistics).
+ */
+class StatusBar : public juce::Component,
+                  public juce::SettableTooltipClient,
+                  private juce::Timer
+{
+public:
+    //==============================================================================
+    StatusBar(LoudnessMeter& inputMeter, LoudnessMeter& outputMeter, GainReductionStats& stats,
+              GainReductionStats& analysis, std::atomic<bool>& analysisReady,
+              const BlockSanitizer::Counters& counters);
+    ~StatusBar() override;
+
+    //==============================================================================
+    void paint(juce::Graphics& g) override;
+    void mouseDown(const juce::MouseEvent& event) override;
+
+private:
+    //==============================================================================
+    void timerCallback() override;
+
+    /** Draw one meter's readings into an area */
+    void drawReadings(juce::Graphics& g, juce::Rectangle<int> area, const juce::String& title,
+                      const LoudnessMeter::Readings& readings) const;
+
+    /** Gain reduction statistics and their histogram into an area */
+    void drawGainReduction(juce::Graphics& g, juce::Rectangle<int> area) const;
+
+    /** LUFS value as text, "--" when there is no reading yet */
+    [[nodiscard]] static juce::String formatLufs(float lufs);
+
+    //==============================================================================
+    LoudnessMeter& inputLoudness;
+    LoudnessMeter& outputLoudness;
+
+    GainReductionStats& gainReductionStats;
+    GainReductionStats& analysisStats;
+    std::atomic<bool>& analysisAvailable;
+    const BlockSanitizer::Counters& sanitizerCounters;
+
+    LoudnessMeter::Readings inputReadings;
+    LoudnessMeter::Readings outputReadings;
+    GainReductionStats::Summary gainReductionSummary;
+    bool showingAnalysis = false;       // gainReductionSummary is from the analysis, not the live stats
+    juce::String diagnosticsText;       // Empty while every block was clean
+
+    juce::SharedResourcePointer<FIDIEditorStyle> style;
+
+    static constexpr int timerRateHz = 10;          // Readings update every 100ms
+    static constexpr int histogramBars = 24;        // 1 dB per bar, up to 24 dB
+    static constexpr int histogramBinsPerBar = 2;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StatusBar)
+};
@@ -0,0 +1,238 @@
+#include "Telemetry.h"
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+#else
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+static juce::uint32 getProcessId() noexcept
+{
+   #if JUCE_WINDOWS
+    return static_cast<juce::uint32>(GetCurrentProcessId());
+   #else
+    return static_cast<juce::uint32>(getpid());
+   #endif
+}
+
+static_assert(StateFormat::parameterOrder.size() <= TelemetryLayout::maxParameters,
+              "Telemetry has no room for the parameter snapshot");
+
+//==============================================================================
+Telemetry::Segment::Segment()
+{
+    constexpr auto size = sizeof(TelemetryLayout::Segment);
+
+   #if JUCE_WINDOWS
+    // Pagefile-backed and zero-filled; lives while any process has it open
+    mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                 0, static_cast<DWORD>(size), TelemetryLayout::windowsName);
+
+    if (mapping == nullptr)
+        return;
+
+    segment = static_cast<TelemetryLayout::Segment*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+   #else
+    // Persists until reboot or shm_unlink, so a dashboard can start first or last
+    const int fd = shm_open(TelemetryLayout::posixName, O_RDWR | O_CREAT, 0666);
+
+    if (fd < 0)
+        return;
+
+    struct stat info {};
+
+    // Growing zero-fills; a segment from an older build is never shrunk
+    if (fstat(fd, &info) == 0 && (static_cast<size_t>(info.st_size) >= size || ftruncate(fd, static_cast<off_t>(size)) == 0))
+    {
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (address != MAP_FAILED)
+            segment = static_cast<TelemetryLayout::Segment*>(address);
+    }
+
+    close(fd);
+   #endif
+
+    if (segment == nullptr)
+        return;
+
+    // Every writer stores the same header, so concurrent initialisation is harmless
+    auto& header = segment->header;
+    header.version = TelemetryLayout::version;
+    header.numSlots = TelemetryLayout::maxSlots;
+    header.slotSize = sizeof(TelemetryLayout::Slot);
+
+    for (size_t i = 0; i < StateFormat::parameterOrder.size(); ++i)
+        juce::String(StateFormat::parameterOrder[i]).copyToUTF8(header.parameterIds[i], TelemetryLayout::parameterIdLength);
+
+    header.magic.store(TelemetryLayout::magic, std::memory_order_release);
+}
+
+Telemetry::Segment::~Segment()
+{
+   #if JUCE_WINDOWS
+    if (segment != nullptr)
+        UnmapViewOfFile(segment);
+
+    if (mapping != nullptr)
+        CloseHandle(mapping);
+   #else
+    if (segment != nullptr)
+        munmap(segment, sizeof(TelemetryLayout::Segment));
+   #endif
+}
+
+TelemetryLayout::Slot* Telemetry::Segment::claim(std::uint64_t newOwner) noexcept
+{
+    if (segment == nullptr)
+        return nullptr;
+
+    const auto now = static_cast<std::int64_t>(juce::Time::currentTimeMillis());
+    const auto processId = newOwner >> 32;
+
+    for (auto& candidate : segment->slots)
+    {
+        auto current = candidate.owner.load(std::memory_order_relaxed);
+
+        // Free, or left behind by another process that stopped updating it. Slots of
+        // this process are never taken over: its timers stall while a session loads.
+        const bool available = current == 0
+                            || ((current >> 32) != processId
+                                && now - candidate.heartbeatMs.load(std::memory_order_relaxed) > TelemetryLayout::staleMilliseconds);
+
+        if (available && candidate.owner.compare_exchange_strong(current, newOwner, std::memory_order_acquire))
+        {
+            // A writer that died mid-write left the sequence odd; start from an even one
+            const auto sequence = candidate.sequence.load(std::memory_order_relaxed);
+            candidate.sequence.store((sequence | 1u) + 1u, std::memory_order_release);
+            candidate.heartbeatMs.store(now, std::memory_order_relaxed);
+            return &candidate;
+        }
+    }
+
+    return nullptr;
+}
+
+void Telemetry::Segment::release(TelemetryLayout::Slot& slot, std::uint64_t oldOwner) noexcept
+{
+    // Unless another process already took it over as stale
+    slot.owner.compare_exchange_strong(oldOwner, 0, std::memory_order_release);
+}
+
+//==============================================================================
+Telemetry::Telemetry(juce::AudioProcessorValueTreeState& apvts)
+    : state(apvts)
+{
+    const auto request = juce::SystemStats::getEnvironmentVariable("FIDI_TELEMETRY", {});
+
+    if (request.isEmpty() || request == "0")
+        return;
+
+    for (size_t i = 0; i < StateFormat::parameterOrder.size(); ++i)
+        parameterValues[i] = state.getRawParameterValue(StateFormat::parameterOrder[i]);
+
+    static std::atomic<juce::uint32> instanceCounter { 0 };
+
+    data.processId = getProcessId();
+    data.instanceId = ++instanceCounter;
+    data.numParameters = static_cast<juce::uint32>(StateFormat::parameterOrder.size());
+    owner = (static_cast<std::uint64_t>(data.processId) << 32) | data.instanceId;
+
+    segment = std::make_unique<juce::SharedResourcePointer<Segment>>();
+    slot = (*segment)->claim(owner);
+
+    if (slot != nullptr)
+        startTimerHz(timerRateHz);
+}
+
+Telemetry::~Telemetry()
+{
+    stopTimer();
+
+    if (slot != nullptr)
+        (*segment)->release(*slot, owner);
+}
+
+void Telemetry::prepare(double sampleRate, int blockSize) noexcept
+{
+    currentSampleRate.store(sampleRate, std::memory_order_relaxed);
+    currentBlockSize.store(blockSize, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void Telemetry::addBlock(int numSamples, juce::int64 ticks) noexcept
+{
+    // Single writer per instance: plain read-modify-write, published with relaxed stores
+    totalBlocks.store(totalBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    totalTicks.store(totalTicks.load(std::memory_order_relaxed) + static_cast<juce::uint64>(ticks), std::memory_order_relaxed);
+    totalSamples.store(totalSamples.load(std::memory_order_relaxed) + static_cast<juce::uint64>(numSamples), std::memory_order_relaxed);
+
+    storeMax(maxTicks, ticks);
+}
+
+void Telemetry::addLevels(float newInputPeak, float newOutputPeak, float newMinGain) noexcept
+{
+    storeMax(inputPeak, newInputPeak);
+    storeMax(outputPeak, newOutputPeak);
+
+    float expected = minGain.load(std::memory_order_relaxed);
+
+    while (newMinGain < expected)
+    {
+        if (minGain.compare_exchange_weak(expected, newMinGain, std::memory_order_relaxed))
+            break;
+    }
+}
+
+//==============================================================================
+void Telemetry::timerCallback()
+{
+    // Taken over by another process while this one stalled: find a new slot
+    if (slot->owner.load(std::memory_order_acquire) != owner)
+    {
+        slot = (*segment)->claim(owner);
+
+        if (slot == nullptr)
+            return;
+    }
+
+    const auto blocks = totalBlocks.load(std::memory_order_relaxed);
+    const auto ticks = totalTicks.load(std::memory_order_relaxed);
+    const auto samples = totalSamples.load(std::memory_order_relaxed);
+
+    const auto intervalBlocks = blocks - lastBlocks;
+    const auto intervalTicks = ticks - lastTicks;
+    const auto intervalSamples = samples - lastSamples;
+
+    lastBlocks = blocks;
+    lastTicks = ticks;
+    lastSamples = samples;
+
+    const double sampleRate = currentSampleRate.load(std::memory_order_relaxed);
+    const double ticksPerMicrosecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) * 1.0e-6;
+    const double busyUs = static_cast<double>(intervalTicks) / ticksPerMicrosecond;
+
+    data.sampleRate = sampleRate;
+    data.blockSize = currentBlockSize.load(std::memory_order_relaxed);
+    data.numBlocks = static_cast<juce::uint32>(intervalBlocks);
+    data.blockAverageUs = intervalBlocks > 0 ? static_cast<float>(busyUs / static_cast<double>(intervalBlocks)) : 0.0f;
+    data.blockMaxUs = static_cast<float>(static_cast<double>(maxTicks.exchange(0, std::memory_order_relaxed)) / ticksPerMicrosecond);
+    data.load = intervalSamples > 0 && sampleRate > 0.0
+                    ? static_cast<float>(busyUs * 1.0e-6 * sampleRate / static_cast<double>(intervalSamples))
+                    : 0.0f;
+
+    data.gainReductionDb = -juce::Decibels::gainToDecibels(minGain.exchange(1.0f, std::memory_order_relaxed));
+    data.inputPeakDb = juce::Decibels::gainToDecibels(inputPeak.exchange(0.0f, std::memory_order_relaxed));
+    data.outputPeakDb = juce::Decibels::gainToDecibels(outputPeak.exchange(0.0f, std::memory_order_relaxed));
+
+    for (size_t i = 0; i < parameterValues.size(); ++i)
+        data.parameters[i] = parameterValues[i] != nullptr ? parameterValues[i]->load(std::memory_order_relaxed) : 0.0f;
+
+    ++data.updateCount;
+
+    TelemetryLayout::write(*slot, data);
+    slot->heartbeatMs.store(static_cast<std::int64_t>(juce::Time::currentTimeMillis()), std::memory_order_relaxed);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "StateFormat.h"
+#include "TelemetryLayout.h"
+
+/**
+ * Per-instance telemetry export for FIDI Comp
+ * Opt-in: only active when the FIDI_TELEMETRY environment variable is set
+ * (to anything but 0) when the plugin loads. The audio thread then adds each
+ * block's duration, peaks and deepest gain reduction to relaxed atomics,
+ * nothing more. A 4 Hz message thread timer turns them into interval
+ * statistics, adds the sample rate, block size and a parameter snapshot, and
+ * writes them into this instance's slot of the shared-memory segment described
+ * in TelemetryLayout.h. No network and no files.
+ */
+class Telemetry : private juce::Timer
+{
+public:
+    //==============================================================================
+    explicit Telemetry(juce::AudioProcessorValueTreeState& apvts);
+    ~Telemetry() override;
+
+    /** True when telemetry was requested and this instance holds a slot */
+    [[nodiscard]] bool isEnabled() const noexcept { return slot != nullptr; }
+
+    /** Sample rate and block size for the next updates (not on the audio thread) */
+    void prepare(double sampleRate, int blockSize) noexcept;
+
+    //==============================================================================
+    // Audio thread, only while enabled
+
+    /** One processed block and how long it took in high resolution ticks */
+    void addBlock(int numSamples, juce::int64 ticks) noexcept;
+
+    /** Peak levels and deepest gain reduction of a block (linear) */
+    void addLevels(float inputPeak, float outputPeak, float minGain) noexcept;
+
+    static constexpr int timerRateHz = 4;
+
+private:
+    //==============================================================================
+    void timerCallback() override;
+
+    /** Keep the largest value since the timer's last exchange (compare-exchange, as the timer also writes) */
+    template <typename T>
+    static void storeMax(std::atomic<T>& target, T value) noexcept
+    {
+        T expected = target.load(std::memory_order_relaxed);
+
+        while (value > expected)
+        {
+            if (target.compare_exchange_weak(expected, value, std::memory_order_relaxed))
+                break;
+        }
+    }
+
+    /** The mapped segment, shared by every instance in the process */
+    class Segment
+    {
+    public:
+        Segment();
+        ~Segment();
+
+        /** Claim a free slot or another process's stale one; nullptr when the segment is unavailable or full */
+        TelemetryLayout::Slot* claim(std::uint64_t owner) noexcept;
+        void release(TelemetryLayout::Slot& slot, std::uint64_t owner) noexcept;
+
+    private:
+        TelemetryLayout::Segment* segment = nullptr;
+
+       #if JUCE_WINDOWS
+        void* mapping = nullptr;
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE(Segment)
+    };
+
+    //==============================================================================
+    juce::AudioProcessorValueTreeState& state;
+    std::array<std::atomic<float>*, StateFormat::parameterOrder.size()> parameterValues{};
+
+    std::unique_ptr<juce::SharedResourcePointer<Segment>> segment;  // Only mapped when enabled
+    TelemetryLayout::Slot* slot = nullptr;
+    std::uint64_t owner = 0;            // Process ID << 32 | instance ID
+    TelemetryLayout::Data data{};
+
+    // Audio thread -> timer: totals (single writer) and maxima taken by exchange
+    std::atomic<juce::uint64> totalBlocks { 0 };
+    std::atomic<juce::uint64> totalTicks { 0 };
+    std::atomic<juce::uint64> totalSamples { 0 };
+    std::atomic<juce::int64> maxTicks { 0 };
+    std::atomic<float> inputPeak { 0.0f };
+    std::atomic<float> outputPeak { 0.0f };
+    std::atomic<float> minGain { 1.0f };
+
+    std::atomic<double> currentSampleRate { 0.0 };
+    std::atomic<int> currentBlockSize { 0 };
+
+    // Timer state: totals at the previous update
+    juce::uint64 lastBlocks = 0;
+    juce::uint64 lastTicks = 0;
+    juce::uint64 lastSamples = 0;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Telemetry)
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Telemetry shared-memory layout for FIDI Comp
+ * One fixed-size segment per machine (user session on Windows): a header,
+ * then one slot per running instance. Written by the plugin's telemetry
+ * exporter, read by dashboards such as Tools/TelemetryReader. Plain C++ with
+ * no JUCE dependency so readers can include it directly.
+ *
+ * Slots are claimed by compare-exchange on the owner field. Each slot's data
+ * is guarded by a seqlock: the writer makes the sequence odd, copies the data,
+ * then makes it even again; a reader copies the data between two equal, even
+ * sequence reads. The layout only grows at the end of Data; the version
+ * changes if existing fields move.
+ */
+namespace TelemetryLayout
+{
+    //==============================================================================
+    constexpr uint32_t magic = 0x4d544446;          // 'F' 'D' 'T' 'M'
+    constexpr uint32_t version = 1;
+
+    constexpr int maxSlots = 64;
+    constexpr int maxParameters = 32;               // StateFormat::parameterOrder, room to append
+    constexpr int parameterIdLength = 16;
+
+    constexpr const char* posixName = "/fidi-comp-telemetry";
+    constexpr const wchar_t* windowsName = L"Local\\FIDICompTelemetry";
+
+    // Slots whose heartbeat is older than this belong to a crashed or hung process
+    constexpr int64_t staleMilliseconds = 10000;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Telemetry slots must be lock-free");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Telemetry slots must be lock-free");
+
+    //==============================================================================
+    /** One instance's published state; levels in dB, times in microseconds */
+    struct Data
+    {
+        uint32_t processId;
+        uint32_t instanceId;                        // Per process, counts from 1
+        double sampleRate;
+        int32_t blockSize;                          // Announced maximum block size
+        uint32_t updateCount;
+
+        // Since the previous update
+        uint32_t numBlocks;
+        float blockAverageUs;
+        float blockMaxUs;
+        float load;                                 // Average block time / block duration
+        float gainReductionDb;                      // Deepest, positive dB
+        float inputPeakDb;
+        float outputPeakDb;
+
+        uint32_t numParameters;
+        float parameters[maxParameters];            // Plain values in Header::parameterIds order
+    };
+
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> owner;                // 0 when free, else processId << 32 | instanceId
+        std::atomic<int64_t> heartbeatMs;           // Wall clock of the last update
+        std::atomic<uint32_t> sequence;             // Odd while the data is being written
+        uint32_t reserved;
+        Data data;
+    };
+
+    struct Header
+    {
+        std::atomic<uint32_t> magic;                // Stored last, once the rest is valid
+        uint32_t version;
+        uint32_t numSlots;
+        uint32_t slotSize;
+        char parameterIds[maxParameters][parameterIdLength];
+    };
+
+    struct Segment
+    {
+        Header header;
+        alignas(64) Slot slots[maxSlots];
+    };
+
+    //==============================================================================
+    /** Seqlock write (the slot's owner only) */
+    inline void write(Slot& slot, const Data& data) noexcept
+    {
+        const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(&slot.data, &data, sizeof(Data));
+
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /** Seqlock read; false if the writer was busy on every attempt */
+    inline bool read(const Slot& slot, Data& data, int attempts = 100) noexcept
+    {
+        for (int attempt = 0; attempt < attempts; ++attempt)
+        {
+            const auto before = slot.sequence.load(std::memory_order_acquire);
+
+            if ((before & 1) != 0)
+                continue;
+
+            std::memcpy(&data, &slot.data, sizeof(Data));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) == before)
+                return true;
+        }
+
+        return false;
+    }
+}
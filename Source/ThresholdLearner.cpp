@@ -0,0 +1,232 @@
+#include "ThresholdLearner.h"
+#include "StaticCurve.h"
+#include "Trace.h"
+
+//==============================================================================
+ThresholdLearner::AnalysisThread::AnalysisThread()
+    : juce::TimeSliceThread("FIDI Comp Learn")
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+ThresholdLearner::AnalysisThread::~AnalysisThread()
+{
+    stopThread(1000);
+}
+
+//==============================================================================
+ThresholdLearner::ThresholdLearner()
+{
+    prepare(48000.0);
+    analysisThread->addTimeSliceClient(this);
+}
+
+ThresholdLearner::~ThresholdLearner()
+{
+    // Waits for a running analysis slice to finish
+    analysisThread->removeTimeSliceClient(this);
+}
+
+//==============================================================================
+void ThresholdLearner::prepare(double sampleRate)
+{
+    cancel();
+
+    pointSize = juce::jmax(1, juce::roundToInt(sampleRate * pointSeconds));
+    pointPosition = 0;
+    pointPeak = 0.0f;
+    pointsPerSecond.store(sampleRate / pointSize);
+}
+
+void ThresholdLearner::start(const Settings& newSettings)
+{
+    // Read by the analysis thread only after it sees startPending
+    pendingRatio.store(newSettings.ratio);
+    pendingKnee.store(newSettings.knee);
+    pendingTargetDb.store(newSettings.targetDb);
+    pendingSeconds.store(newSettings.seconds);
+    suggestionReady.store(false);
+    startPending.store(true);
+    listening.store(true);
+}
+
+void ThresholdLearner::cancel() noexcept
+{
+    listening.store(false);
+    cancelPending.store(true);
+}
+
+void ThresholdLearner::cancelWhileBypassed() noexcept
+{
+    // The detector does not run while bypassed, so the learn time would never be reached
+    if (listening.load(std::memory_order_relaxed))
+        cancel();
+}
+
+//==============================================================================
+void ThresholdLearner::push(float linkedLevel, int numSamples) noexcept
+{
+    if (! listening.load(std::memory_order_relaxed))
+    {
+        pointPosition = 0;
+        pointPeak = 0.0f;
+        return;
+    }
+
+    pointPeak = std::max(pointPeak, linkedLevel);
+    pointPosition += numSamples;
+
+    if (pointPosition < pointSize)
+        return;
+
+    // A full FIFO (analysis thread stalled) drops the point
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+        fifoData[static_cast<size_t>(start1)] = pointPeak;
+
+    fifo.finishedWrite(size1);
+
+    pointPosition -= pointSize;
+    pointPeak = 0.0f;
+}
+
+bool ThresholdLearner::takeSuggestion(Suggestion& suggestion) noexcept
+{
+    if (! suggestionReady.exchange(false))
+        return false;
+
+    suggestion.valid = suggestionValid.load();
+    suggestion.thresholdDb = suggestedThresholdDb.load();
+    suggestion.makeupDb = suggestedMakeupDb.load();
+    suggestion.averageDb = suggestedAverageDb.load();
+    return true;
+}
+
+//==============================================================================
+int ThresholdLearner::useTimeSlice()
+{
+    FIDI_TRACE_SCOPE("ThresholdLearner::useTimeSlice");
+
+    if (cancelPending.exchange(false))
+        active = false;
+
+    if (startPending.exchange(false))
+    {
+        settings.ratio = pendingRatio.load();
+        settings.knee = pendingKnee.load();
+        settings.targetDb = pendingTargetDb.load();
+        settings.seconds = pendingSeconds.load();
+        histogram.fill(0);
+        numPoints = 0;
+        numPointsRequired = juce::jmax(1, juce::roundToInt(settings.seconds * pointsPerSecond.load()));
+        active = true;
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    // Points left over from a cancelled run are dropped
+    auto addPoint = [this](float level)
+    {
+        const float levelDb = level > 0.0f ? 20.0f * std::log10(level) : minLevelDb;
+        const int bin = juce::jlimit(0, numBins - 1, static_cast<int>((levelDb - minLevelDb) * binsPerDb));
+        ++histogram[static_cast<size_t>(bin)];
+        ++numPoints;
+    };
+
+    if (active)
+    {
+        for (int i = 0; i < size1; ++i)
+            addPoint(fifoData[static_cast<size_t>(start1 + i)]);
+
+        for (int i = 0; i < size2; ++i)
+            addPoint(fifoData[static_cast<size_t>(start2 + i)]);
+    }
+
+    fifo.finishedRead(size1 + size2);
+
+    if (active && numPoints >= numPointsRequired)
+    {
+        active = false;
+
+        const auto suggestion = suggest();
+        suggestionValid.store(suggestion.valid);
+        suggestedThresholdDb.store(suggestion.thresholdDb);
+        suggestedMakeupDb.store(suggestion.makeupDb);
+        suggestedAverageDb.store(suggestion.averageDb);
+
+        // Published before listening ends, so a poller that sees it end finds the result
+        suggestionReady.store(true);
+        listening.store(false);
+    }
+
+    return active ? 50 : 200;
+}
+
+//==============================================================================
+float ThresholdLearner::getAverageReductionDb(float thresholdDb) const noexcept
+{
+    const auto curve = StaticCurve::create(thresholdDb, settings.ratio, settings.knee, minLevelDb, 1.0f, 1.0f);
+    double sum = 0.0;
+    juce::uint64 count = 0;
+
+    // Bins below the knee add nothing; each bin is evaluated at its centre
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const auto binCount = histogram[static_cast<size_t>(bin)];
+        const float levelDb = minLevelDb + (static_cast<float>(bin) + 0.5f) / binsPerDb;
+
+        sum += static_cast<double>(binCount) * curve.getCompressionDb(levelDb);
+        count += binCount;
+    }
+
+    return count > 0 ? static_cast<float>(sum / static_cast<double>(count)) : 0.0f;
+}
+
+ThresholdLearner::Suggestion ThresholdLearner::suggest() const noexcept
+{
+    Suggestion suggestion;
+
+    juce::uint64 numAudible = 0;
+
+    for (int bin = static_cast<int>((silenceDb - minLevelDb) * binsPerDb); bin < numBins; ++bin)
+        numAudible += histogram[static_cast<size_t>(bin)];
+
+    // Mostly silence (stopped transport, muted track): nothing to learn from
+    if (numAudible * 10 < static_cast<juce::uint64>(numPoints))
+        return suggestion;
+
+    // Average reduction falls as the threshold rises: bisect within the parameter range
+    float low = minThresholdDb;
+    float high = maxThresholdDb;
+
+    if (getAverageReductionDb(low) <= settings.targetDb)
+    {
+        high = low;
+    }
+    else if (getAverageReductionDb(high) >= settings.targetDb)
+    {
+        low = high;
+    }
+    else
+    {
+        for (int iteration = 0; iteration < 20; ++iteration)
+        {
+            const float middle = 0.5f * (low + high);
+
+            if (getAverageReductionDb(middle) > settings.targetDb)
+                low = middle;
+            else
+                high = middle;
+        }
+    }
+
+    // Parameter resolution is 0.1 dB
+    suggestion.valid = true;
+    suggestion.thresholdDb = std::round(0.5f * (low + high) * 10.0f) / 10.0f;
+    suggestion.averageDb = getAverageReductionDb(suggestion.thresholdDb);
+    suggestion.makeupDb = juce::jlimit(minMakeupDb, maxMakeupDb, std::round(suggestion.averageDb * 10.0f) / 10.0f);
+    return suggestion;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Auto-threshold learn mode for FIDI Comp
+ * While listening, the audio thread pushes the peak of the linked detector
+ * level every 5ms into a preallocated lock-free FIFO, nothing more. A
+ * low-priority thread builds a fixed-memory level histogram from those points
+ * (0.25 dB bins, so any quantile is read back to within a bin), and after the
+ * learn time searches for the threshold whose compression segment gives the
+ * target average gain reduction over the material. The makeup that restores
+ * the average level is proposed with it.
+ */
+class ThresholdLearner : private juce::TimeSliceClient
+{
+public:
+    //==============================================================================
+    /** What to learn for; read by the analysis thread when listening starts */
+    struct Settings
+    {
+        float ratio = 4.0f;             // Current ratio and knee: only the threshold is searched
+        float knee = 6.0f;
+        float targetDb = 3.0f;          // Average gain reduction to aim for, positive dB
+        double seconds = 5.0;           // Playback to listen to
+    };
+
+    struct Suggestion
+    {
+        bool valid = false;             // False when the material stayed below the level floor
+        float thresholdDb = 0.0f;
+        float makeupDb = 0.0f;          // Restores the average level lost to the reduction
+        float averageDb = 0.0f;         // Average reduction the threshold achieves, positive dB
+    };
+
+    ThresholdLearner();
+    ~ThresholdLearner() override;
+
+    //==============================================================================
+    /** Set the decimation for a sample rate and cancel listening (not on the audio thread) */
+    void prepare(double sampleRate);
+
+    /** Start listening (message thread) */
+    void start(const Settings& settings);
+
+    /** Stop listening without a suggestion (message thread) */
+    void cancel() noexcept;
+
+    [[nodiscard]] bool isListening() const noexcept { return listening.load(std::memory_order_relaxed); }
+
+    /** Stop listening because the instance is bypassed (audio thread; the editor sees no suggestion) */
+    void cancelWhileBypassed() noexcept;
+
+    /** Peak linked detector level of a sub-block (audio thread, no-op unless listening) */
+    void push(float linkedLevel, int numSamples) noexcept;
+
+    /** Fetch a finished suggestion once (message thread). False while none is ready. */
+    bool takeSuggestion(Suggestion& suggestion) noexcept;
+
+    //==============================================================================
+    static constexpr float minThresholdDb = -60.0f;    // Threshold parameter range
+    static constexpr float maxThresholdDb = 0.0f;
+    static constexpr float minMakeupDb = -12.0f;       // Makeup parameter range
+    static constexpr float maxMakeupDb = 24.0f;
+
+private:
+    //==============================================================================
+    int useTimeSlice() override;
+
+    /** Average reduction of the compression segment over the histogram for a threshold */
+    [[nodiscard]] float getAverageReductionDb(float thresholdDb) const noexcept;
+
+    /** Threshold search over the finished histogram (analysis thread) */
+    [[nodiscard]] Suggestion suggest() const noexcept;
+
+    //==============================================================================
+    static constexpr double pointSeconds = 0.005;       // One histogram point per 5ms of audio
+    static constexpr float minLevelDb = -90.0f;         // Quieter points count as silence
+    static constexpr float maxLevelDb = 12.0f;
+    static constexpr float binsPerDb = 4.0f;
+    static constexpr int numBins = static_cast<int>((maxLevelDb - minLevelDb) * binsPerDb);
+    static constexpr float silenceDb = -70.0f;          // Material needs some points above this
+
+    // Audio thread state
+    std::atomic<bool> listening { false };
+    int pointSize = 240;
+    int pointPosition = 0;
+    float pointPeak = 0.0f;
+
+    // Level points, audio thread -> analysis thread (about 5s at the point rate)
+    static constexpr int fifoSize = 1024;
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<float, fifoSize> fifoData{};
+
+    // Message thread -> analysis thread. Settings are atomics: a start while the
+    // analysis thread reads the previous one sets startPending again, so the
+    // next slice restarts with a consistent set.
+    std::atomic<float> pendingRatio { 4.0f };
+    std::atomic<float> pendingKnee { 6.0f };
+    std::atomic<float> pendingTargetDb { 3.0f };
+    std::atomic<double> pendingSeconds { 5.0 };
+    std::atomic<bool> startPending { false };
+    std::atomic<bool> cancelPending { false };
+    std::atomic<double> pointsPerSecond { 200.0 };
+
+    // Analysis thread state
+    Settings settings;
+    bool active = false;
+    int numPoints = 0;
+    int numPointsRequired = 0;
+    std::array<juce::uint32, numBins> histogram{};
+
+    // Published result
+    std::atomic<bool> suggestionReady { false };
+    std::atomic<bool> suggestionValid { false };
+    std::atomic<float> suggestedThresholdDb { 0.0f };
+    std::atomic<float> suggestedMakeupDb { 0.0f };
+    std::atomic<float> suggestedAverageDb { 0.0f };
+
+    /** One low-priority thread for the learners of every instance in the process */
+    struct AnalysisThread : public juce::TimeSliceThread
+    {
+        AnalysisThread();
+        ~AnalysisThread() override;
+    };
+
+    juce::SharedResourcePointer<AnalysisThread> analysisThread;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ThresholdLearner)
+};
@@ -0,0 +1,182 @@
+#include "Trace.h"
+
+#if FIDI_ENABLE_TRACING
+
+namespace
+{
+    //==============================================================================
+    // Events kept per thread; older events are overwritten once the ring wraps
+    constexpr juce::uint64 eventsPerThread = 1 << 16;
+    static_assert((eventsPerThread & (eventsPerThread - 1)) == 0, "Ring size must be a power of two");
+
+    /** Single-producer ring written only by its owning thread */
+    struct ThreadBuffer
+    {
+        std::array<Trace::Event, eventsPerThread> events{};
+        std::atomic<juce::uint64> writeIndex{0};
+        int threadIndex = 0;
+        juce::String threadName;
+    };
+
+    /** Owns every thread buffer for the lifetime of the process so dumps can read them */
+    struct Registry
+    {
+        juce::CriticalSection lock;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        int activeSessions = 0;
+    };
+
+    Registry& getRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    ThreadBuffer& getThreadBuffer()
+    {
+        // Registration takes the lock once per thread; every later record() is wait-free
+        thread_local ThreadBuffer* buffer = []
+        {
+            auto& registry = getRegistry();
+            const juce::ScopedLock sl(registry.lock);
+
+            auto newBuffer = std::make_unique<ThreadBuffer>();
+            newBuffer->threadIndex = static_cast<int>(registry.buffers.size()) + 1;
+
+            if (auto* thread = juce::Thread::getCurrentThread())
+                newBuffer->threadName = thread->getThreadName();
+            else if (juce::MessageManager::getInstanceWithoutCreating() != nullptr
+                     && juce::MessageManager::getInstanceWithoutCreating()->isThisTheMessageThread())
+                newBuffer->threadName = "Message Thread";
+            else
+                newBuffer->threadName = "Host Thread " + juce::String(newBuffer->threadIndex);
+
+            registry.buffers.push_back(std::move(newBuffer));
+            return registry.buffers.back().get();
+        }();
+
+        return *buffer;
+    }
+}
+
+//==============================================================================
+Trace::Session::Session() noexcept
+{
+    auto& registry = getRegistry();
+    const juce::ScopedLock sl(registry.lock);
+    ++registry.activeSessions;
+}
+
+Trace::Session::~Session()
+{
+    auto& registry = getRegistry();
+    bool isLast = false;
+
+    {
+        const juce::ScopedLock sl(registry.lock);
+        isLast = --registry.activeSessions == 0;
+    }
+
+    if (isLast)
+        Trace::writeChromeTrace(Trace::getDefaultDumpFile());
+}
+
+//==============================================================================
+void Trace::record(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept
+{
+    auto& buffer = getThreadBuffer();
+
+    const auto index = buffer.writeIndex.load(std::memory_order_relaxed);
+    buffer.events[index & (eventsPerThread - 1)] = { name, startTicks, endTicks };
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+//==============================================================================
+bool Trace::writeChromeTrace(const juce::File& file)
+{
+    struct Snapshot
+    {
+        int threadIndex;
+        juce::String threadName;
+        std::vector<Event> events;
+    };
+
+    std::vector<Snapshot> snapshots;
+    juce::int64 originTicks = std::numeric_limits<juce::int64>::max();
+
+    {
+        auto& registry = getRegistry();
+        const juce::ScopedLock sl(registry.lock);
+
+        for (auto& buffer : registry.buffers)
+        {
+            Snapshot snapshot{ buffer->threadIndex, buffer->threadName, {} };
+
+            const auto end = buffer->writeIndex.load(std::memory_order_acquire);
+            const auto begin = end > eventsPerThread ? end - eventsPerThread : 0;
+
+            snapshot.events.reserve(static_cast<size_t>(end - begin));
+            for (auto i = begin; i < end; ++i)
+                snapshot.events.push_back(buffer->events[i & (eventsPerThread - 1)]);
+
+            // The owner may have wrapped over the oldest entries while we copied them
+            const auto endAfterCopy = buffer->writeIndex.load(std::memory_order_acquire);
+            const auto firstValid = endAfterCopy > eventsPerThread ? endAfterCopy - eventsPerThread : 0;
+            if (firstValid > begin)
+            {
+                const auto numTorn = std::min(static_cast<size_t>(firstValid - begin), snapshot.events.size());
+                snapshot.events.erase(snapshot.events.begin(),
+                                      snapshot.events.begin() + static_cast<std::ptrdiff_t>(numTorn));
+            }
+
+            for (const auto& event : snapshot.events)
+                originTicks = std::min(originTicks, event.startTicks);
+
+            snapshots.push_back(std::move(snapshot));
+        }
+    }
+
+    juce::FileOutputStream stream(file);
+    if (!stream.openedOk())
+        return false;
+
+    stream.setPosition(0);
+    stream.truncate();
+
+    auto toMicroseconds = [](juce::int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+    };
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    for (const auto& snapshot : snapshots)
+    {
+        stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+               << snapshot.threadIndex << ",\"args\":{\"name\":"
+               << juce::JSON::toString(juce::var(snapshot.threadName)) << "}}";
+        first = false;
+
+        for (const auto& event : snapshot.events)
+        {
+            stream << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"fidi\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                   << snapshot.threadIndex
+                   << ",\"ts\":" << juce::String(toMicroseconds(event.startTicks - originTicks), 3)
+                   << ",\"dur\":" << juce::String(toMicroseconds(event.endTicks - event.startTicks), 3)
+                   << "}";
+        }
+    }
+
+    stream << "\n]}\n";
+    stream.flush();
+    return stream.getStatus().wasOk();
+}
+
+juce::File Trace::getDefaultDumpFile()
+{
+    return juce::File::getSpecialLocation(juce::File::tempDirectory)
+        .getChildFile("FIDIComp-trace-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json");
+}
+
+#endif
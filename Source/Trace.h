@@ -0,0 +1,75 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef FIDI_ENABLE_TRACING
+ #define FIDI_ENABLE_TRACING 0
+#endif
+
+#if FIDI_ENABLE_TRACING
+
+/**
+ * Trace-event instrumentation for FIDI Comp diagnostic builds
+ * Scoped zones record begin/end timestamps into a per-thread lock-free ring
+ * buffer. The collected timeline can be written as Chrome trace / Perfetto JSON.
+ * When FIDI_ENABLE_TRACING is 0 the macros below compile to nothing.
+ */
+class Trace
+{
+public:
+    //==============================================================================
+    /** One completed zone as stored in the per-thread buffer */
+    struct Event
+    {
+        const char* name = nullptr;     // Must be a string literal (pointer is stored)
+        juce::int64 startTicks = 0;
+        juce::int64 endTicks = 0;
+    };
+
+    //==============================================================================
+    /** RAII zone: records the time between construction and destruction */
+    class Scope
+    {
+    public:
+        explicit Scope(const char* zoneName) noexcept
+            : name(zoneName), startTicks(juce::Time::getHighResolutionTicks()) {}
+
+        ~Scope() noexcept { Trace::record(name, startTicks, juce::Time::getHighResolutionTicks()); }
+
+    private:
+        const char* name;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    //==============================================================================
+    /** Held by each plugin instance; the trace is dumped when the last one goes away */
+    class Session
+    {
+    public:
+        Session() noexcept;
+        ~Session();
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE(Session)
+    };
+
+    //==============================================================================
+    /** Append a completed zone to the calling thread's buffer (wait-free after first use) */
+    static void record(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+
+    /** Write all buffered events as Chrome trace JSON. Returns false if the file could not be written. */
+    static bool writeChromeTrace(const juce::File& file);
+
+    /** Timestamped file in the temp directory used when a session ends */
+    [[nodiscard]] static juce::File getDefaultDumpFile();
+};
+
+ #define FIDI_TRACE_SCOPE(zoneName) const Trace::Scope JUCE_JOIN_MACRO(fidiTraceScope_, __LINE__)(zoneName)
+
+#else
+
+ #define FIDI_TRACE_SCOPE(zoneName)
+
+#endif
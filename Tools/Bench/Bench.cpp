@@ -0,0 +1,380 @@
+/**
+ * Benchmark for FIDI Comp
+ * Runs the processor without a host and prints the cost per sample of
+ * processBlock, best of several passes over the same material.
+ *
+ *   FIDIBench            every section
+ *   FIDIBench --blocks   block sizes 1 to 4096, active and bypassed
+ *   FIDIBench --tiers    the three quality tiers
+ *   FIDIBench --kernels  all 12 detector kernels (detector x domain x topology)
+ *   FIDIBench --stereo   L/R at 100%, 50% and 0% link, and M/S
+ *   FIDIBench --state    session save and recall, binary state against legacy XML
+ *   FIDIBench --editor   editor open and repaint times against the README targets
+ *
+ * Configure with -DFIDI_BUILD_BENCH=ON and build in Release. Timings include
+ * everything processBlock does (parameter update, sanitizer, metering,
+ * limiter delay), as a host would see it.
+ */
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels = 2;
+    constexpr int numSamples = 96000;   // Two seconds per pass
+    constexpr int numPasses = 5;
+    constexpr int sectionBlockSize = 512;  // Host block size of the sections that compare settings
+    constexpr int numEditorOpens = 10;
+    constexpr int numEditorFrames = 30;
+    constexpr int numStateCalls = 1000;
+
+    double getMillisecondsSince(juce::int64 startTicks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    }
+
+    //==============================================================================
+    void setParameter(FIDICompProcessor& processor, const char* parameterId, float plainValue)
+    {
+        auto* parameter = processor.getAPVTS().getParameter(parameterId);
+        jassert(parameter != nullptr);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(plainValue));
+    }
+
+    juce::String getParameterText(FIDICompProcessor& processor, const char* parameterId)
+    {
+        return processor.getAPVTS().getParameter(parameterId)->getCurrentValueAsText();
+    }
+
+    /** Noise whose level steps between -40 and 0 dBFS every 100ms, so the detector keeps attacking and releasing */
+    juce::AudioBuffer<float> makeInput()
+    {
+        juce::AudioBuffer<float> input(numChannels, numSamples);
+        juce::Random random(1);
+        const int stepSamples = static_cast<int>(sampleRate * 0.1);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* samples = input.getWritePointer(ch);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float level = (i / stepSamples) % 2 == 0 ? 1.0f : 0.01f;
+                samples[i] = level * (random.nextFloat() * 2.0f - 1.0f);
+            }
+        }
+
+        return input;
+    }
+
+    /** Run the material through processBlock in blocks of blockSize, returns the seconds taken */
+    double processPass(FIDICompProcessor& processor, juce::AudioBuffer<float>& work, int blockSize)
+    {
+        juce::MidiBuffer midi;
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int position = 0; position + blockSize <= work.getNumSamples(); position += blockSize)
+        {
+            juce::AudioBuffer<float> block(work.getArrayOfWritePointers(), numChannels, position, blockSize);
+            processor.processBlock(block, midi);
+        }
+
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    }
+
+    /**
+     * Nanoseconds per sample of processBlock at one block size, with the
+     * processor's current settings. One untimed pass first, so parameter
+     * smoothing and the bypass fade have settled.
+     */
+    double timeProcess(FIDICompProcessor& processor, const juce::AudioBuffer<float>& input, int blockSize)
+    {
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> work;
+        work.makeCopyOf(input);
+        processPass(processor, work, blockSize);
+
+        double best = std::numeric_limits<double>::max();
+
+        for (int pass = 0; pass < numPasses; ++pass)
+        {
+            work.makeCopyOf(input, true);
+            best = std::min(best, processPass(processor, work, blockSize));
+        }
+
+        const int processedSamples = (numSamples / blockSize) * blockSize;
+        return best * 1.0e9 / processedSamples;
+    }
+
+    //==============================================================================
+    /** Per-call overhead: cost per sample from 1-sample to 4096-sample host blocks */
+    void benchBlockSizes(const juce::AudioBuffer<float>& input)
+    {
+        std::printf("\nprocessBlock per block size (ns/sample, default settings)\n");
+        std::printf("  %-8s %10s %10s\n", "block", "active", "bypassed");
+
+        for (int blockSize = 1; blockSize <= 4096; blockSize *= 2)
+        {
+            FIDICompProcessor processor;
+            const double active = timeProcess(processor, input, blockSize);
+
+            setParameter(processor, "bypass", 1.0f);
+            const double bypassed = timeProcess(processor, input, blockSize);
+
+            std::printf("  %-8d %10.2f %10.2f\n", blockSize, active, bypassed);
+        }
+    }
+
+    /** Eco, Standard and High with the default detector kernel */
+    void benchTiers(const juce::AudioBuffer<float>& input)
+    {
+        std::printf("\nprocessBlock per quality tier (ns/sample, %d-sample blocks)\n", sectionBlockSize);
+
+        for (int tier = 0; tier < 3; ++tier)
+        {
+            FIDICompProcessor processor;
+            setParameter(processor, "quality", static_cast<float>(tier));
+
+            std::printf("  %-40s %8.2f\n", getParameterText(processor, "quality").toRawUTF8(),
+                        timeProcess(processor, input, sectionBlockSize));
+        }
+    }
+
+    /** Every detector, domain and topology combination, each its own kernel instantiation */
+    void benchKernels(const juce::AudioBuffer<float>& input)
+    {
+        std::printf("\nprocessBlock per detector kernel (ns/sample, %d-sample blocks)\n", sectionBlockSize);
+
+        for (int detector = 0; detector < 3; ++detector)
+        {
+            for (int domain = 0; domain < 2; ++domain)
+            {
+                for (int topology = 0; topology < 2; ++topology)
+                {
+                    FIDICompProcessor processor;
+                    setParameter(processor, "detector", static_cast<float>(detector));
+                    setParameter(processor, "detectorDomain", static_cast<float>(domain));
+                    setParameter(processor, "topology", static_cast<float>(topology));
+
+                    const auto name = getParameterText(processor, "detector") + " / "
+                                    + getParameterText(processor, "detectorDomain") + " / "
+                                    + getParameterText(processor, "topology");
+
+                    std::printf("  %-40s %8.2f\n", name.toRawUTF8(), timeProcess(processor, input, sectionBlockSize));
+                }
+            }
+        }
+    }
+
+    /** Stereo link and mode: the single linked detector against the two-lane paths */
+    void benchStereo(const juce::AudioBuffer<float>& input)
+    {
+        std::printf("\nprocessBlock per stereo setting (ns/sample, %d-sample blocks)\n", sectionBlockSize);
+
+        struct StereoSetting
+        {
+            const char* name;
+            float stereoMode;
+            float link;
+        };
+
+        for (const auto& setting : { StereoSetting { "L/R, link 100%", 0.0f, 100.0f },
+                                     StereoSetting { "L/R, link 50%", 0.0f, 50.0f },
+                                     StereoSetting { "L/R, link 0%", 0.0f, 0.0f },
+                                     StereoSetting { "M/S, link 100%", 1.0f, 100.0f } })
+        {
+            FIDICompProcessor processor;
+            setParameter(processor, "stereoMode", setting.stereoMode);
+            setParameter(processor, "link", setting.link);
+
+            std::printf("  %-40s %8.2f\n", setting.name, timeProcess(processor, input, sectionBlockSize));
+        }
+    }
+
+    /** Microseconds per call of a state function, best of the passes */
+    double timeStateCalls(const std::function<void()>& call)
+    {
+        double best = std::numeric_limits<double>::max();
+
+        for (int pass = 0; pass < numPasses; ++pass)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numStateCalls; ++i)
+                call();
+
+            best = std::min(best, getMillisecondsSince(start) * 1000.0 / numStateCalls);
+        }
+
+        return best;
+    }
+
+    /**
+     * getStateInformation and setStateInformation of one instance, as a host
+     * saving or recalling a session calls them. The legacy rows write and read
+     * the XML state of earlier versions, which setStateInformation still loads.
+     */
+    void benchState()
+    {
+        FIDICompProcessor processor;
+        auto& apvts = processor.getAPVTS();
+
+        juce::MemoryBlock binaryState;
+        processor.getStateInformation(binaryState);
+
+        auto writeLegacy = [&apvts](juce::MemoryBlock& destination)
+        {
+            const auto xml = apvts.copyState().createXml();
+            juce::AudioProcessor::copyXmlToBinary(*xml, destination);
+        };
+
+        juce::MemoryBlock legacyState;
+        writeLegacy(legacyState);
+
+        juce::MemoryBlock scratch;
+
+        std::printf("\nState per instance (us/call)\n");
+        std::printf("  %-40s %8.2f  (%d bytes)\n", "getStateInformation, binary",
+                    timeStateCalls([&] { processor.getStateInformation(scratch); }), static_cast<int>(binaryState.getSize()));
+        std::printf("  %-40s %8.2f\n", "setStateInformation, binary",
+                    timeStateCalls([&] { processor.setStateInformation(binaryState.getData(), static_cast<int>(binaryState.getSize())); }));
+        std::printf("  %-40s %8.2f  (%d bytes)\n", "get state, legacy XML",
+                    timeStateCalls([&] { writeLegacy(scratch); }), static_cast<int>(legacyState.getSize()));
+        std::printf("  %-40s %8.2f\n", "setStateInformation, legacy XML",
+                    timeStateCalls([&] { processor.setStateInformation(legacyState.getData(), static_cast<int>(legacyState.getSize())); }));
+    }
+
+    //==============================================================================
+    /**
+     * Opens and closes the editor of one instance several times, painting each
+     * into an image. The first paint of an editor renders the cached background,
+     * later ones blit it as the 30 Hz meter repaints do; the whole editor is
+     * timed, so the repaint figure is an upper bound for the meter and status bar.
+     */
+    void benchEditor()
+    {
+        FIDICompProcessor processor;
+        double firstOpenMs = 0.0;
+        double worstReopenMs = 0.0;
+        double firstPaintMs = 0.0;
+        double worstRepaintMs = 0.0;
+
+        for (int open = 0; open < numEditorOpens; ++open)
+        {
+            auto start = juce::Time::getHighResolutionTicks();
+            std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditorIfNeeded());
+            const double openMs = getMillisecondsSince(start);
+
+            if (open == 0)
+                firstOpenMs = openMs;
+            else
+                worstReopenMs = std::max(worstReopenMs, openMs);
+
+            juce::Image image(juce::Image::ARGB, editor->getWidth(), editor->getHeight(), true);
+
+            for (int frame = 0; frame < numEditorFrames; ++frame)
+            {
+                juce::Graphics g(image);
+                start = juce::Time::getHighResolutionTicks();
+                editor->paintEntireComponent(g, true);
+                const double paintMs = getMillisecondsSince(start);
+
+                if (open == 0 && frame == 0)
+                    firstPaintMs = paintMs;
+                else if (frame > 0)
+                    worstRepaintMs = std::max(worstRepaintMs, paintMs);
+            }
+        }
+
+        auto printRow = [](const char* name, double milliseconds, double targetMs)
+        {
+            if (targetMs > 0.0)
+                std::printf("  %-40s %8.2f  target < %.0f ms: %s\n", name, milliseconds, targetMs,
+                            milliseconds < targetMs ? "met" : "MISSED");
+            else
+                std::printf("  %-40s %8.2f\n", name, milliseconds);
+        };
+
+        std::printf("\nEditor (ms)\n");
+        printRow("first open in the process", firstOpenMs, 0.0);
+        printRow("first paint", firstPaintMs, 0.0);
+        printRow("reopen, worst", worstReopenMs, 5.0);
+        printRow("repaint with cached background, worst", worstRepaintMs, 1.0);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    bool all = argc < 2;
+    bool blocks = false;
+    bool tiers = false;
+    bool kernels = false;
+    bool stereo = false;
+    bool state = false;
+    bool editor = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--blocks") == 0)
+        {
+            blocks = true;
+        }
+        else if (std::strcmp(argv[i], "--tiers") == 0)
+        {
+            tiers = true;
+        }
+        else if (std::strcmp(argv[i], "--kernels") == 0)
+        {
+            kernels = true;
+        }
+        else if (std::strcmp(argv[i], "--stereo") == 0)
+        {
+            stereo = true;
+        }
+        else if (std::strcmp(argv[i], "--state") == 0)
+        {
+            state = true;
+        }
+        else if (std::strcmp(argv[i], "--editor") == 0)
+        {
+            editor = true;
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // Parameter listeners and the shared analysis threads expect a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto input = makeInput();
+
+    if (all || blocks)
+        benchBlockSizes(input);
+
+    if (all || tiers)
+        benchTiers(input);
+
+    if (all || kernels)
+        benchKernels(input);
+
+    if (all || stereo)
+        benchStereo(input);
+
+    if (all || state)
+        benchState();
+
+    if (all || editor)
+        benchEditor();
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+/**
+ * Multi-instance stress test for FIDI Comp
+ * Runs processors on worker threads, one each, as a host's audio threads
+ * would: random block sizes up to 4096, sample rate changes, automation of
+ * random parameters (link groups included) and noise input. Meanwhile the
+ * main thread, as the message thread, saves and restores state and switches
+ * presets. Runs 1, 2, 4 ... N instances in turn and prints the throughput,
+ * its scaling over one instance, and the worst block time and load.
+ *
+ *   FIDIStress [--instances N] [--seconds S]   N defaults to the CPU count, S (per run) to 5
+ *
+ * Configure with -DFIDI_BUILD_STRESS=ON; add -DFIDI_ENABLE_TSAN=ON to have
+ * ThreadSanitizer report races on stderr.
+ */
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    constexpr std::array<double, 4> sampleRates { 44100.0, 48000.0, 88200.0, 96000.0 };
+    constexpr int numChannels = 2;
+    constexpr int maxBlockSize = 4096;
+    constexpr int messageIntervalMs = 20;
+
+    //==============================================================================
+    /** One processor, its audio thread and what that thread measured */
+    struct Instance
+    {
+        FIDICompProcessor processor;
+        std::thread thread;
+
+        juce::int64 samplesProcessed = 0;
+        double worstBlockSeconds = 0.0;
+        double worstLoad = 0.0;         // Block time over the block's duration
+    };
+
+    /** Audio thread of one instance; runs until running is cleared */
+    void runInstance(Instance& instance, int seed, const std::atomic<bool>& running)
+    {
+        juce::Random random(seed);
+        auto& processor = instance.processor;
+        const auto& parameters = processor.getParameters();
+
+        juce::AudioBuffer<float> noise(numChannels, maxBlockSize);
+        juce::AudioBuffer<float> buffer(numChannels, maxBlockSize);
+        juce::MidiBuffer midi;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < maxBlockSize; ++i)
+                noise.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        double sampleRate = 0.0;
+        int blocksUntilRateChange = 0;
+
+        while (running.load(std::memory_order_relaxed))
+        {
+            // As a host does it: processing stops, then the new rate is prepared
+            if (--blocksUntilRateChange <= 0)
+            {
+                sampleRate = sampleRates[static_cast<size_t>(random.nextInt(static_cast<int>(sampleRates.size())))];
+                processor.releaseResources();
+                processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+                processor.prepareToPlay(sampleRate, maxBlockSize);
+                blocksUntilRateChange = 200 + random.nextInt(2000);
+            }
+
+            // Half the blocks any size up to the maximum, half a power of two
+            const int blockSize = random.nextBool() ? 1 + random.nextInt(maxBlockSize) : 1 << random.nextInt(13);
+
+            // Host automation arrives on the audio thread before the block
+            if (random.nextInt(4) == 0)
+                parameters[random.nextInt(parameters.size())]->setValueNotifyingHost(random.nextFloat());
+
+            const float level = random.nextFloat();
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.copyFromWithRamp(ch, 0, noise.getReadPointer(ch), blockSize, level, level);
+
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, 0, blockSize);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(block, midi);
+            const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            instance.samplesProcessed += blockSize;
+            instance.worstBlockSeconds = std::max(instance.worstBlockSeconds, seconds);
+            instance.worstLoad = std::max(instance.worstLoad, seconds * sampleRate / blockSize);
+        }
+
+        processor.releaseResources();
+    }
+
+    //==============================================================================
+    struct RunResult
+    {
+        double samplesPerSecond = 0.0;
+        double worstBlockSeconds = 0.0;
+        double worstLoad = 0.0;
+    };
+
+    /** Run numInstances processors for the given time while this thread plays the message thread */
+    RunResult run(int numInstances, double seconds)
+    {
+        std::vector<std::unique_ptr<Instance>> instances;
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            instances.push_back(std::make_unique<Instance>());
+
+            // A third of the instances stay out of link groups, the rest share two
+            auto* linkGroup = instances.back()->processor.getAPVTS().getParameter("linkGroup");
+            linkGroup->setValueNotifyingHost(linkGroup->convertTo0to1(static_cast<float>(i % 3)));
+        }
+
+        std::atomic<bool> running { true };
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numInstances; ++i)
+            instances[static_cast<size_t>(i)]->thread = std::thread(runInstance, std::ref(*instances[static_cast<size_t>(i)]),
+                                                                    i + 1, std::cref(running));
+
+        juce::Random random(0);
+        juce::MemoryBlock state;
+
+        while (juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) < seconds)
+        {
+            auto& processor = instances[static_cast<size_t>(random.nextInt(numInstances))]->processor;
+
+            // Session save and recall, and preset changes, while the audio threads run
+            processor.getStateInformation(state);
+
+            if (random.nextInt(4) == 0)
+                processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+            if (random.nextInt(8) == 0)
+                processor.setCurrentProgram(random.nextInt(processor.getNumPrograms()));
+
+            juce::Thread::sleep(messageIntervalMs);
+        }
+
+        running.store(false);
+
+        for (auto& instance : instances)
+            instance->thread.join();
+
+        const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        RunResult result;
+
+        for (const auto& instance : instances)
+        {
+            result.samplesPerSecond += static_cast<double>(instance->samplesProcessed) / elapsed;
+            result.worstBlockSeconds = std::max(result.worstBlockSeconds, instance->worstBlockSeconds);
+            result.worstLoad = std::max(result.worstLoad, instance->worstLoad);
+        }
+
+        return result;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    int maxInstances = juce::SystemStats::getNumCpus();
+    double seconds = 5.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--instances") == 0 && i + 1 < argc)
+        {
+            maxInstances = juce::jmax(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            seconds = juce::jmax(0.1, std::atof(argv[++i]));
+        }
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--instances N] [--seconds S]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // This thread is the message thread
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    std::printf("%-10s %16s %9s %18s %11s\n", "instances", "Msamples/s", "scaling", "worst block (us)", "worst load");
+
+    double singleInstance = 0.0;
+
+    for (int numInstances = 1;; numInstances = juce::jmin(maxInstances, numInstances * 2))
+    {
+        const auto result = run(numInstances, seconds);
+
+        if (numInstances == 1)
+            singleInstance = result.samplesPerSecond;
+
+        std::printf("%-10d %16.2f %8.2fx %18.1f %10.0f%%\n", numInstances, result.samplesPerSecond * 1.0e-6,
+                    result.samplesPerSecond / singleInstance, result.worstBlockSeconds * 1.0e6, result.worstLoad * 100.0);
+
+        if (numInstances == maxInstances)
+            break;
+    }
+
+    return 0;
+}
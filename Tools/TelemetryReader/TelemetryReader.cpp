@@ -0,0 +1,140 @@
+/**
+ * Reference reader for the FIDI Comp telemetry segment
+ * Prints one line per running instance (plugins loaded with FIDI_TELEMETRY=1).
+ *
+ *   FIDITelemetryReader              print once
+ *   FIDITelemetryReader --watch      print every second
+ *   FIDITelemetryReader --parameters also print each instance's parameters
+ *
+ * Maps the segment read-only and never writes to it.
+ */
+
+#include "../../Source/TelemetryLayout.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#if defined(_WIN32)
+ #include <windows.h>
+#else
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <unistd.h>
+#endif
+
+//==============================================================================
+static const TelemetryLayout::Segment* openSegment()
+{
+    constexpr auto size = sizeof(TelemetryLayout::Segment);
+
+   #if defined(_WIN32)
+    HANDLE mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, TelemetryLayout::windowsName);
+
+    if (mapping == nullptr)
+        return nullptr;
+
+    return static_cast<const TelemetryLayout::Segment*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size));
+   #else
+    const int fd = shm_open(TelemetryLayout::posixName, O_RDONLY, 0);
+
+    if (fd < 0)
+        return nullptr;
+
+    void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    return address != MAP_FAILED ? static_cast<const TelemetryLayout::Segment*>(address) : nullptr;
+   #endif
+}
+
+static int64_t currentTimeMillis()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+static void print(const TelemetryLayout::Segment& segment, bool withParameters)
+{
+    const auto now = currentTimeMillis();
+
+    std::printf("%-14s %8s %6s %10s %10s %6s %7s %8s %8s\n",
+                "instance", "rate", "block", "avg us", "max us", "load", "GR dB", "in dB", "out dB");
+
+    for (const auto& slot : segment.slots)
+    {
+        if (slot.owner.load(std::memory_order_acquire) == 0
+            || now - slot.heartbeatMs.load(std::memory_order_relaxed) > TelemetryLayout::staleMilliseconds)
+            continue;
+
+        TelemetryLayout::Data data;
+
+        if (! TelemetryLayout::read(slot, data))
+            continue;
+
+        char instance[32];
+        std::snprintf(instance, sizeof(instance), "%u:%u", data.processId, data.instanceId);
+
+        std::printf("%-14s %8.0f %6d %10.1f %10.1f %5.1f%% %7.1f %8.1f %8.1f\n",
+                    instance, data.sampleRate, data.blockSize, data.blockAverageUs, data.blockMaxUs,
+                    data.load * 100.0f, data.gainReductionDb, data.inputPeakDb, data.outputPeakDb);
+
+        if (! withParameters)
+            continue;
+
+        const auto numParameters = std::min<uint32_t>(data.numParameters, TelemetryLayout::maxParameters);
+
+        for (uint32_t i = 0; i < numParameters; ++i)
+        {
+            char id[TelemetryLayout::parameterIdLength + 1] {};
+            std::memcpy(id, segment.header.parameterIds[i], TelemetryLayout::parameterIdLength);
+            std::printf("    %-16s %g\n", id, static_cast<double>(data.parameters[i]));
+        }
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    bool watch = false;
+    bool withParameters = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--watch") == 0)
+            watch = true;
+        else if (std::strcmp(argv[i], "--parameters") == 0)
+            withParameters = true;
+    }
+
+    const auto* segment = openSegment();
+
+    if (segment == nullptr)
+    {
+        std::fprintf(stderr, "No telemetry segment (no instance has run with FIDI_TELEMETRY=1)\n");
+        return 1;
+    }
+
+    if (segment->header.magic.load(std::memory_order_acquire) != TelemetryLayout::magic
+        || segment->header.version != TelemetryLayout::version)
+    {
+        std::fprintf(stderr, "Telemetry segment has an unknown layout\n");
+        return 1;
+    }
+
+    do
+    {
+        print(*segment, withParameters);
+
+        if (watch)
+        {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            std::printf("\n");
+        }
+    }
+    while (watch);
+
+    return 0;
+}
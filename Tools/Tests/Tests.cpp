@@ -0,0 +1,546 @@
+/**
+ * Golden-reference tests for FIDI Comp
+ * Generates the reference corpus, renders it through the processor in each
+ * quality tier, with each detector kernel and with the stereo, auto release
+ * and limiter settings, and compares the renders with the committed goldens
+ * from a reference build (exact kernels), against the error budgets in the
+ * README. Also renders a long file serially and in parallel segments and
+ * checks that the renderer's reported seam error bounds the difference.
+ * Exits non-zero when any check fails.
+ *
+ *   FIDIReferenceRender --write-goldens <dir>   render the goldens (reference build only)
+ *   FIDITests --goldens <dir>                   compare a normal build against them
+ *
+ * Both are built with -DFIDI_BUILD_TESTS=ON. CTest runs FIDITests against
+ * Tools/Tests/Goldens; the FIDIUpdateGoldens target rewrites that directory.
+ */
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+#include "PluginProcessor.h"
+#include "SharedTables.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels = 2;
+    constexpr float minInputLevel = 1.0e-4f;    // Quieter input samples do not define a gain
+    constexpr int settleSamples = 24000;        // Steady files are compared after 0.5 s
+    constexpr float minTransitionDb = 1.0f;     // Smaller gain moves are not timed
+    constexpr double corpusSeconds = 1.0;       // Per file; short, since the goldens are committed
+
+    //==============================================================================
+    /** One corpus file and what it is checked for */
+    struct CorpusFile
+    {
+        const char* name;
+        juce::AudioBuffer<float> audio;
+        bool steady = false;                    // Constant level, for the steady Eco budget
+        int changeInterval = 0;                 // Level steps this often, for the timing budget
+        bool everySetting = false;              // Rendered in every setting, not only in the tiers
+    };
+
+    /** Error budget of one setting against its golden (see README, Reference Builds) */
+    struct Budget
+    {
+        float maxGainErrorDb;
+        float steadyGainErrorDb;
+        int maxTimingError;                     // Samples
+    };
+
+    constexpr Budget ecoBudget { 0.2f, 0.05f, 8 };              // Control rate, fast log
+    constexpr Budget tableBudget { 1.0e-4f, 1.0e-4f, 0 };       // Tables in place of std::exp and std::pow
+    constexpr Budget autoReleaseBudget { 5.0e-4f, 5.0e-4f, 0 }; // Tables; coefficient error adds up over long releases
+
+    /** One rendered configuration: parameters changed from the defaults, and its budget */
+    struct Setting
+    {
+        juce::String name;
+        std::vector<std::pair<const char*, float>> parameters;
+        Budget budget;
+        bool wholeCorpus = false;
+    };
+
+    constexpr double coefficientTimeBudget = 0.006e-2;  // Relative time constant error of the coefficient table
+
+    constexpr double seamFileSeconds = 60.0;
+    constexpr double seamSegmentSeconds = 5.0;
+
+    //==============================================================================
+    juce::AudioBuffer<float> makeBuffer(double seconds)
+    {
+        juce::AudioBuffer<float> buffer(numChannels, juce::roundToInt(seconds * sampleRate));
+        buffer.clear();
+        return buffer;
+    }
+
+    void fillSine(juce::AudioBuffer<float>& buffer, double frequency, const std::function<float(int)>& getLevel)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, getLevel(i) * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate)));
+    }
+
+    void fillNoise(juce::AudioBuffer<float>& buffer, int start, int end, const std::function<float(int)>& getLevel, juce::Random& random)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = start; i < end; ++i)
+                buffer.setSample(ch, i, getLevel(i) * (random.nextFloat() * 2.0f - 1.0f));
+    }
+
+    /** The corpus listed in the README: every branch of the gain path */
+    std::vector<CorpusFile> generateCorpus()
+    {
+        std::vector<CorpusFile> corpus;
+        juce::Random random(0x46444943);
+        const int step = juce::roundToInt(0.1 * sampleRate);
+
+        // Steady compression
+        auto sine = makeBuffer(corpusSeconds);
+        fillSine(sine, 1000.0, [](int) { return juce::Decibels::decibelsToGain(-6.0f); });
+        corpus.push_back({ "sine", std::move(sine), true, 0, false });
+
+        // Attack and release: 0 dBFS and -40 dBFS alternating every 100ms
+        auto bursts = makeBuffer(corpusSeconds);
+        fillSine(bursts, 200.0, [step](int i) { return (i / step) % 2 == 0 ? 1.0f : 0.01f; });
+        corpus.push_back({ "bursts", std::move(bursts), false, step, true });
+
+        // Dense material with a high crest factor
+        auto noise = makeBuffer(corpusSeconds);
+        fillNoise(noise, 0, noise.getNumSamples(), [](int) { return 0.5f; }, random);
+        corpus.push_back({ "noise", std::move(noise), false, 0, false });
+
+        // Long releases between loud sections, which auto release shortens
+        auto noiseBursts = makeBuffer(corpusSeconds);
+        fillNoise(noiseBursts, 0, noiseBursts.getNumSamples(), [](int i) { return (i / 12000) % 2 == 0 ? 1.0f : 0.03f; }, random);
+        corpus.push_back({ "noiseBursts", std::move(noiseBursts), false, 0, true });
+
+        // Release to unity in digital silence, then a block of denormals for the sanitizer
+        auto silence = makeBuffer(corpusSeconds);
+        fillNoise(silence, 0, 12000, [](int) { return 0.5f; }, random);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 36000; i < 36512; ++i)
+                silence.setSample(ch, i, 1.0e-40f);
+
+        corpus.push_back({ "silence", std::move(silence), false, 0, false });
+
+        // Sanitizer and detector reset
+        auto nonFinite = makeBuffer(corpusSeconds);
+        fillNoise(nonFinite, 0, nonFinite.getNumSamples(), [](int) { return 0.5f; }, random);
+        nonFinite.setSample(0, 15000, std::numeric_limits<float>::quiet_NaN());
+        nonFinite.setSample(1, 30000, std::numeric_limits<float>::infinity());
+        corpus.push_back({ "nonFinite", std::move(nonFinite), false, 0, false });
+
+        // Every curve segment, including the knee: -60 to 0 dBFS
+        auto sweep = makeBuffer(corpusSeconds);
+        const int sweepLength = sweep.getNumSamples();
+        fillSine(sweep, 1000.0, [sweepLength](int i) { return juce::Decibels::decibelsToGain(-60.0f + 60.0f * i / sweepLength); });
+        corpus.push_back({ "sweep", std::move(sweep), false, 0, true });
+
+        return corpus;
+    }
+
+    //==============================================================================
+    void setParameter(FIDICompProcessor& processor, const char* parameterId, float plainValue)
+    {
+        auto* parameter = processor.getAPVTS().getParameter(parameterId);
+        jassert(parameter != nullptr);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(plainValue));
+    }
+
+    /**
+     * The three tiers with the default settings over the whole corpus, then the
+     * other 11 detector kernels, M/S, partial link, auto release and the limiter
+     * in Standard over the files that move the gain.
+     */
+    std::vector<Setting> getSettings()
+    {
+        std::vector<Setting> settings {
+            { "eco",      { { "quality", 0.0f } }, ecoBudget, true },
+            { "standard", { { "quality", 1.0f } }, tableBudget, true },
+            { "high",     { { "quality", 2.0f } }, tableBudget, true }
+        };
+
+        const juce::StringArray detectors { "branching", "decoupled", "smoothPeak" };
+        const juce::StringArray domains { "linear", "log" };
+        const juce::StringArray topologies { "feedForward", "feedback" };
+
+        for (int detector = 0; detector < detectors.size(); ++detector)
+            for (int domain = 0; domain < domains.size(); ++domain)
+                for (int topology = 0; topology < topologies.size(); ++topology)
+                    if (detector + domain + topology > 0)   // The default kernel is "standard"
+                        settings.push_back({ detectors[detector] + "-" + domains[domain] + "-" + topologies[topology],
+                                             { { "detector", static_cast<float>(detector) },
+                                               { "detectorDomain", static_cast<float>(domain) },
+                                               { "topology", static_cast<float>(topology) } },
+                                             tableBudget });
+
+        settings.push_back({ "midSide", { { "stereoMode", 1.0f } }, tableBudget });
+        settings.push_back({ "link50", { { "link", 50.0f } }, tableBudget });
+        settings.push_back({ "autoRelease", { { "autoRelease", 1.0f } }, autoReleaseBudget });
+        settings.push_back({ "limiter", { { "limiter", 1.0f } }, tableBudget });
+        return settings;
+    }
+
+    /** State of one setting; HQ Render off, since the renderer runs the processor offline */
+    juce::MemoryBlock getState(const Setting& setting)
+    {
+        FIDICompProcessor processor;
+        setParameter(processor, "offlineHigh", 0.0f);
+
+        for (const auto& [parameterId, value] : setting.parameters)
+            setParameter(processor, parameterId, value);
+
+        juce::MemoryBlock state;
+        processor.getStateInformation(state);
+        return state;
+    }
+
+    /** The settings a corpus file is rendered in */
+    bool isRendered(const CorpusFile& file, const Setting& setting)
+    {
+        return setting.wholeCorpus || file.everySetting;
+    }
+
+    /** Serial render (one segment), latency trimmed */
+    juce::AudioBuffer<float> render(const juce::AudioBuffer<float>& input, const juce::MemoryBlock& state)
+    {
+        OfflineRenderer::Options options;
+        options.segmentSeconds = 3600.0;
+
+        juce::AudioBuffer<float> output;
+        const auto report = OfflineRenderer::render(state, input, output, sampleRate, options);
+        jassertquiet(report.succeeded && report.numSegments == 1);
+        return output;
+    }
+
+    //==============================================================================
+    bool readWav(const juce::File& file, juce::AudioBuffer<float>& audio)
+    {
+        if (! file.existsAsFile())
+            return false;
+
+        juce::WavAudioFormat format;
+        std::unique_ptr<juce::AudioFormatReader> reader(format.createReaderFor(file.createInputStream().release(), true));
+
+        if (reader == nullptr)
+            return false;
+
+        audio.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+        return reader->read(&audio, 0, audio.getNumSamples(), 0, true, true);
+    }
+
+    juce::File getGoldenFile(const juce::File& directory, const CorpusFile& file, const Setting& setting)
+    {
+        return directory.getChildFile(juce::String(file.name) + "-" + setting.name + ".wav");
+    }
+
+    //==============================================================================
+    struct Comparison
+    {
+        float maxGainErrorDb = 0.0f;
+        float steadyGainErrorDb = 0.0f;
+        int timingError = 0;
+    };
+
+    /** Gain per sample of one channel in dB (output over input), held where the input is too quiet */
+    std::vector<float> getGainCurve(const juce::AudioBuffer<float>& input, const juce::AudioBuffer<float>& output, int channel)
+    {
+        std::vector<float> curve(static_cast<size_t>(input.getNumSamples()));
+        float held = 0.0f;
+
+        for (int i = 0; i < input.getNumSamples(); ++i)
+        {
+            const float in = input.getSample(channel, i);
+
+            if (std::isfinite(in) && std::abs(in) >= minInputLevel)
+                held = juce::Decibels::gainToDecibels(std::abs(output.getSample(channel, i) / in), -200.0f);
+
+            curve[static_cast<size_t>(i)] = held;
+        }
+
+        return curve;
+    }
+
+    /**
+     * Gain error: both renders are the same input times a gain, so their ratio
+     * is the ratio of the gains. Timing error: at every level step, the distance
+     * between the samples where each render's gain passes the midpoint of the
+     * reference's move.
+     */
+    Comparison compare(const CorpusFile& file, const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& golden)
+    {
+        Comparison result;
+        const int numSamples = file.audio.getNumSamples();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float in = file.audio.getSample(ch, i);
+
+                if (! std::isfinite(in) || std::abs(in) < minInputLevel)
+                    continue;
+
+                const float a = std::abs(rendered.getSample(ch, i));
+                const float b = std::abs(golden.getSample(ch, i));
+
+                // Both silenced (a repaired block) is a match; one of them alone, or non-finite output, is not
+                if (a == 0.0f && b == 0.0f)
+                    continue;
+
+                const float error = a > 0.0f && b > 0.0f && std::isfinite(a) && std::isfinite(b)
+                                  ? std::abs(juce::Decibels::gainToDecibels(a / b, -1000.0f))
+                                  : std::numeric_limits<float>::infinity();
+
+                result.maxGainErrorDb = std::max(result.maxGainErrorDb, error);
+
+                if (file.steady && i >= settleSamples)
+                    result.steadyGainErrorDb = std::max(result.steadyGainErrorDb, error);
+            }
+
+            if (file.changeInterval <= 0)
+                continue;
+
+            const auto reference = getGainCurve(file.audio, golden, ch);
+            const auto test = getGainCurve(file.audio, rendered, ch);
+
+            for (int start = file.changeInterval; start + file.changeInterval <= numSamples; start += file.changeInterval)
+            {
+                const int end = start + file.changeInterval;
+                const float from = reference[static_cast<size_t>(start - 1)];
+                const float to = reference[static_cast<size_t>(end - 1)];
+
+                if (std::abs(to - from) < minTransitionDb)
+                    continue;
+
+                const float midpoint = 0.5f * (from + to);
+
+                auto getCrossing = [&](const std::vector<float>& curve)
+                {
+                    for (int i = start; i < end; ++i)
+                        if ((curve[static_cast<size_t>(i)] - midpoint) * (to - from) >= 0.0f)
+                            return i;
+
+                    return end;
+                };
+
+                result.timingError = std::max(result.timingError, std::abs(getCrossing(test) - getCrossing(reference)));
+            }
+        }
+
+        return result;
+    }
+
+    //==============================================================================
+   #if FIDI_REFERENCE_KERNELS
+    bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& audio)
+    {
+        file.deleteFile();
+        auto stream = std::make_unique<juce::FileOutputStream>(file);
+
+        if (! stream->openedOk())
+            return false;
+
+        juce::WavAudioFormat format;
+        std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(stream.get(), sampleRate,
+                                                                               static_cast<unsigned int>(audio.getNumChannels()),
+                                                                               32, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release();   // Owned by the writer
+        return writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+    }
+
+    int writeGoldens(const juce::File& directory)
+    {
+        if (! directory.createDirectory())
+        {
+            std::fprintf(stderr, "Cannot create %s\n", directory.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        const auto settings = getSettings();
+
+        for (const auto& file : generateCorpus())
+        {
+            for (const auto& setting : settings)
+            {
+                if (! isRendered(file, setting))
+                    continue;
+
+                const auto golden = getGoldenFile(directory, file, setting);
+
+                if (! writeWav(golden, render(file.audio, getState(setting))))
+                {
+                    std::fprintf(stderr, "Cannot write %s\n", golden.getFullPathName().toRawUTF8());
+                    return 1;
+                }
+            }
+        }
+
+        std::printf("Goldens written to %s\n", directory.getFullPathName().toRawUTF8());
+        return 0;
+    }
+   #endif
+
+    /** The coefficient table row: the time constant a table coefficient implies, against the requested one */
+    bool checkCoefficientTable()
+    {
+        double worst = 0.0;
+
+        for (double rate : { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 })
+        {
+            const SharedTables::CoefficientTable table(rate);
+
+            for (double timeMs = 0.1; timeMs <= 60000.0; timeMs *= 1.01)
+            {
+                const double impliedMs = -1000.0 / (rate * std::log(table.getCoefficient(timeMs)));
+                worst = std::max(worst, std::abs(impliedMs - timeMs) / timeMs);
+            }
+        }
+
+        const bool passed = worst <= coefficientTimeBudget;
+        std::printf("  %-12s %-30s time constant %.4f%% (budget %.4f%%)  %s\n", "tables", "coeff",
+                    worst * 100.0, coefficientTimeBudget * 100.0, passed ? "ok" : "FAILED");
+        return passed;
+    }
+
+    /**
+     * A minute of noise stepping to a random level between -40 and 0 dBFS every
+     * 370ms, rendered serially and in 5 s segments: Report::maxSeamError must
+     * bound the difference over the whole file, not only in the verified windows.
+     * Standard, Eco (control periods) and the limiter (chunks, with a ceiling
+     * low enough to work on this material) each check their own phase.
+     */
+    bool checkSeams()
+    {
+        auto input = makeBuffer(seamFileSeconds);
+        juce::Random random(0x5345414d);
+        const int step = juce::roundToInt(0.37 * sampleRate);
+        std::vector<float> levels(static_cast<size_t>(input.getNumSamples() / step + 1));
+
+        for (auto& level : levels)
+            level = juce::Decibels::decibelsToGain(-40.0f * random.nextFloat());
+
+        fillNoise(input, 0, input.getNumSamples(), [&levels, step](int i) { return levels[static_cast<size_t>(i / step)]; }, random);
+
+        const std::vector<Setting> settings {
+            { "standard", {}, tableBudget },
+            { "eco",      { { "quality", 0.0f } }, ecoBudget },
+            { "limiter",  { { "limiter", 1.0f }, { "ceiling", -20.0f } }, tableBudget }
+        };
+
+        bool allPassed = true;
+
+        for (const auto& setting : settings)
+        {
+            const auto state = getState(setting);
+            const auto serial = render(input, state);
+
+            OfflineRenderer::Options options;
+            options.segmentSeconds = seamSegmentSeconds;
+
+            juce::AudioBuffer<float> segmented;
+            const auto report = OfflineRenderer::render(state, input, segmented, sampleRate, options);
+
+            float difference = 0.0f;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < input.getNumSamples(); ++i)
+                    difference = std::max(difference, std::abs(segmented.getSample(ch, i) - serial.getSample(ch, i)));
+
+            const bool passed = report.succeeded && report.numSegments > 1 && difference <= report.maxSeamError;
+            std::printf("  %-12s %-30s %d segments, %d rerendered, difference %.3g (reported seam error %.3g)  %s\n",
+                        "seams", setting.name.toRawUTF8(), report.numSegments, report.numRerenders, difference,
+                        report.maxSeamError, passed ? "ok" : "FAILED");
+            allPassed = allPassed && passed;
+        }
+
+        return allPassed;
+    }
+
+    int runChecks(const juce::File& directory)
+    {
+        int numFailed = checkCoefficientTable() ? 0 : 1;
+
+        if (! checkSeams())
+            ++numFailed;
+
+        const auto settings = getSettings();
+
+        for (const auto& file : generateCorpus())
+        {
+            for (const auto& setting : settings)
+            {
+                if (! isRendered(file, setting))
+                    continue;
+
+                juce::AudioBuffer<float> golden;
+
+                if (! readWav(getGoldenFile(directory, file, setting), golden)
+                    || golden.getNumChannels() != numChannels || golden.getNumSamples() != file.audio.getNumSamples())
+                {
+                    std::fprintf(stderr, "Missing or invalid golden for %s (%s); build FIDIUpdateGoldens and commit %s\n",
+                                 file.name, setting.name.toRawUTF8(), directory.getFullPathName().toRawUTF8());
+                    return 1;
+                }
+
+                const auto& budget = setting.budget;
+                const auto result = compare(file, render(file.audio, getState(setting)), golden);
+
+                const bool passed = result.maxGainErrorDb <= budget.maxGainErrorDb
+                                 && result.steadyGainErrorDb <= budget.steadyGainErrorDb
+                                 && result.timingError <= budget.maxTimingError;
+
+                std::printf("  %-12s %-30s gain %.5f dB, steady %.5f dB, timing %d  %s\n", file.name,
+                            setting.name.toRawUTF8(), result.maxGainErrorDb, result.steadyGainErrorDb,
+                            result.timingError, passed ? "ok" : "FAILED");
+
+                if (! passed)
+                    ++numFailed;
+            }
+        }
+
+        if (numFailed > 0)
+        {
+            std::printf("%d checks over budget\n", numFailed);
+            return 1;
+        }
+
+        std::printf("All checks within budget\n");
+        return 0;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    if (argc != 3 || (std::strcmp(argv[1], "--write-goldens") != 0 && std::strcmp(argv[1], "--goldens") != 0))
+    {
+        std::fprintf(stderr, "Usage: %s --write-goldens <dir> | --goldens <dir>\n", argv[0]);
+        return 1;
+    }
+
+    // Parameter listeners and the shared analysis threads expect a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto directory = juce::File::getCurrentWorkingDirectory().getChildFile(argv[2]);
+
+    if (std::strcmp(argv[1], "--write-goldens") == 0)
+    {
+       #if FIDI_REFERENCE_KERNELS
+        return writeGoldens(directory);
+       #else
+        std::fprintf(stderr, "Goldens must come from a reference build (FIDIReferenceRender)\n");
+        return 1;
+       #endif
+    }
+
+    return runChecks(directory);
+}